@@ -3,3 +3,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+// Stat group for all gameplay systems in this module ("stat TGM")
+DECLARE_STATS_GROUP(TEXT("TGM"), STATGROUP_TGM, STATCAT_Advanced);
@@ -2,15 +2,24 @@
 
 #include "TGMCharacter.h"
 #include "TGMProjectile.h"
+#include "TGMGameMode.h"
+#include "TGMHealthComponent.h"
+#include "TGMExplosionDamage.h"
+#include "TGM.h"
 #include "Animation/AnimInstance.h"
 #include "Camera/CameraComponent.h"
 #include "Components/CapsuleComponent.h"
 #include "Components/InputComponent.h"
 #include "GameFramework/InputSettings.h"
 #include "Kismet/GameplayStatics.h"
+#include "Algo/BinarySearch.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogFPChar, Warning, All);
 
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hit Claims Accepted"), STAT_TGMHitClaimsAccepted, STATGROUP_TGM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Hit Claims Rejected"), STAT_TGMHitClaimsRejected, STATGROUP_TGM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Shots Rejected"), STAT_TGMShotsRejected, STATGROUP_TGM);
+
 //////////////////////////////////////////////////////////////////////////
 // ATGMCharacter
 
@@ -52,6 +61,17 @@ ATGMCharacter::ATGMCharacter()
 
 	// Default offset from the character location for projectiles to spawn
 	GunOffset = FVector(100.0f, 0.0f, 10.0f);
+
+	// Fire rate
+	MinFireInterval = 0.5f;
+	FireIntervalTolerance = 0.1f;
+	LastFireTime = -BIG_NUMBER;
+	NextShotId = 0;
+	ShotAllowance = 1.0f;
+	ShotAllowanceTime = 0.0f;
+
+	// Create the health component, damaged by explosions
+	HealthComponent = CreateDefaultSubobject<UTGMHealthComponent>(TEXT("HealthComponent"));
 }
 
 void ATGMCharacter::BeginPlay()
@@ -63,6 +83,106 @@ void ATGMCharacter::BeginPlay()
 	FP_Gun->AttachToComponent(Mesh1P, FAttachmentTransformRules(EAttachmentRule::SnapToTarget, true), TEXT("GripPoint"));
 
 	Mesh1P->SetHiddenInGame(false, true);
+
+	HitboxHistory.Reset(GetCapsuleComponent()->GetScaledCapsuleRadius(), GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+}
+
+void ATGMCharacter::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	// Only the server validates hits, so only it needs the history
+	if (HasAuthority())
+	{
+		HitboxHistory.Record(GetWorld()->GetTimeSeconds(), GetCapsuleComponent()->GetComponentLocation());
+	}
+}
+
+void ATGMCharacter::ServerRegisterShot_Implementation(uint16 ShotId)
+{
+	const float Now = GetWorld()->GetTimeSeconds();
+
+	// Refill at the fire rate. The allowance may dip slightly below zero so a shot arriving early after network jitter
+	// is still registered, but over time no more shots than the fire rate allows get through.
+	if (MinFireInterval > 0.0f)
+	{
+		ShotAllowance = FMath::Min(1.0f, ShotAllowance + (Now - ShotAllowanceTime) / MinFireInterval);
+		ShotAllowanceTime = Now;
+
+		if (ShotAllowance < 1.0f - FireIntervalTolerance / MinFireInterval)
+		{
+			INC_DWORD_STAT(STAT_TGMShotsRejected);
+			UE_LOG(LogFPChar, Verbose, TEXT("Rejected shot %u from %s, fired too fast"), ShotId, *GetName());
+			return;
+		}
+
+		ShotAllowance -= 1.0f;
+	}
+
+	PruneServerShots();
+
+	FTGMServerShot& Shot = ServerShots.AddDefaulted_GetRef();
+	Shot.ShotId = ShotId;
+	Shot.FireTime = Now;
+}
+
+void ATGMCharacter::PruneServerShots()
+{
+	ATGMGameMode* GameMode = GetWorld()->GetAuthGameMode<ATGMGameMode>();
+	const ATGMProjectile* Projectile = (ProjectileClass != nullptr) ? ProjectileClass->GetDefaultObject<ATGMProjectile>() : nullptr;
+
+	if (GameMode == nullptr || Projectile == nullptr)
+	{
+		ServerShots.Reset();
+		return;
+	}
+
+	// A claim can arrive up to the rewind window after the projectile's lifespan
+	const float OldestFireTime = GetWorld()->GetTimeSeconds() - Projectile->GetProjectileLifeSpan() - GameMode->GetMaxRewindTime();
+	const int32 NumExpired = Algo::LowerBound(ServerShots, OldestFireTime, [](const FTGMServerShot& Shot, float Time)
+	{
+		return Shot.FireTime < Time;
+	});
+
+	ServerShots.RemoveAt(0, NumExpired, false);
+}
+
+void ATGMCharacter::ServerReportHit_Implementation(const FTGMHitClaim& Claim)
+{
+	ATGMGameMode* GameMode = GetWorld()->GetAuthGameMode<ATGMGameMode>();
+
+	PruneServerShots();
+
+	// Claims need a registered shot, and each shot damages each target at most once
+	FTGMServerShot* Shot = ServerShots.FindByPredicate([&Claim](const FTGMServerShot& ServerShot)
+	{
+		return ServerShot.ShotId == Claim.ShotId;
+	});
+
+	FVector RewoundTargetLocation;
+
+	if (GameMode != nullptr && Shot != nullptr && !Shot->ClaimedTargets.Contains(Claim.Target)
+		&& GameMode->ValidateHitClaim(this, Claim, Shot->FireTime, RewoundTargetLocation))
+	{
+		INC_DWORD_STAT(STAT_TGMHitClaimsAccepted);
+		Shot->ClaimedTargets.Add(Claim.Target);
+
+		// Damage only the claimed target, placed where the impact was relative to it when the client saw it
+		UTGMExplosionDamageSubsystem* ExplosionDamageSubsystem = GetWorld()->GetSubsystem<UTGMExplosionDamageSubsystem>();
+		if (ExplosionDamageSubsystem != nullptr)
+		{
+			const FVector ImpactLocation = Claim.ImpactLocation + (Claim.Target->GetActorLocation() - RewoundTargetLocation);
+			FTGMExplosion Explosion = ProjectileClass->GetDefaultObject<ATGMProjectile>()->MakeExplosion(ImpactLocation, this);
+			Explosion.Target = Claim.Target;
+
+			ExplosionDamageSubsystem->QueueExplosion(Explosion);
+		}
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_TGMHitClaimsRejected);
+		UE_LOG(LogFPChar, Verbose, TEXT("Rejected hit claim from %s on %s for shot %u at %.3f"), *GetName(), *GetNameSafe(Claim.Target), Claim.ShotId, Claim.Timestamp);
+	}
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -95,6 +215,12 @@ void ATGMCharacter::SetupPlayerInputComponent(class UInputComponent* PlayerInput
 
 void ATGMCharacter::OnFire()
 {
+	// Respect the fire rate, the server won't accept hits from faster shots anyway
+	if (GetWorld()->GetTimeSeconds() - LastFireTime < MinFireInterval)
+	{
+		return;
+	}
+
 	// try and fire a projectile
 	if (ProjectileClass != nullptr)
 	{
@@ -119,6 +245,16 @@ void ATGMCharacter::OnFire()
 				ActiveProjectile->FireInDirection(LaunchDirection, this);
 
 				OldRotation = SpawnRotation;
+				InFlightProjectile = ActiveProjectile;
+				LastFireTime = World->GetTimeSeconds();
+
+				// Clients' projectiles only exist locally, so the server learns of the shot to validate its hits
+				ActiveProjectile->SetShotId(NextShotId);
+				if (GetNetMode() == NM_Client)
+				{
+					ServerRegisterShot(NextShotId);
+				}
+				NextShotId++;
 
 				// Let the controller assume control of the projectile now
 				Controller->Possess(ActiveProjectile);
@@ -144,6 +280,11 @@ void ATGMCharacter::OnFire()
 	}
 }
 
+ATGMProjectile* ATGMCharacter::GetInFlightProjectile() const
+{
+	return InFlightProjectile.Get();
+}
+
 void ATGMCharacter::MoveForward(float Value)
 {
 	if (Value != 0.0f)
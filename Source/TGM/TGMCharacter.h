@@ -4,6 +4,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
+#include "TGMHitboxHistory.h"
 #include "TGMCharacter.generated.h"
 
 class UInputComponent;
@@ -14,6 +15,18 @@ class UMotionControllerComponent;
 class UAnimMontage;
 class USoundBase;
 
+/** Shot a client registered with the server, kept while hit claims for it may still arrive */
+struct FTGMServerShot
+{
+	uint16 ShotId;
+
+	// Server world time the shot was registered at
+	float FireTime;
+
+	// Characters already damaged through claims on this shot
+	TArray<TWeakObjectPtr<class ATGMCharacter>, TInlineAllocator<4>> ClaimedTargets;
+};
+
 UCLASS(config=Game)
 class ATGMCharacter : public ACharacter
 {
@@ -35,6 +48,10 @@ class ATGMCharacter : public ACharacter
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	UCameraComponent* FirstPersonCameraComponent;
 
+	/** Health, damaged by explosions */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Health, meta = (AllowPrivateAccess = "true"))
+	class UTGMHealthComponent* HealthComponent;
+
 public:
 	ATGMCharacter();
 
@@ -42,6 +59,22 @@ protected:
 	virtual void BeginPlay();
 
 public:
+	virtual void Tick(float DeltaSeconds) override;
+
+	/**
+	 * Sent by the owning client when it fires. The server only accepts hit claims for registered shots,
+	 * and registers at most one shot per MinFireInterval.
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerRegisterShot(uint16 ShotId);
+
+	/**
+	 * Sent by the owning client when one of its projectiles hit or exploded next to another character.
+	 * The server validates the claim against the target's rewound hitbox, and accepts one claim per shot and target.
+	 */
+	UFUNCTION(Server, Reliable)
+	void ServerReportHit(const FTGMHitClaim& Claim);
+
 	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
 	float BaseTurnRate;
@@ -58,6 +91,14 @@ public:
 	UPROPERTY(EditDefaultsOnly, Category=Projectile)
 	TSubclassOf<class ATGMProjectile> ProjectileClass;
 
+	/** Minimum time between shots, in seconds. Also enforced by the server on registered shots. */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile)
+	float MinFireInterval;
+
+	/** How much earlier than MinFireInterval a shot may reach the server, to absorb network jitter */
+	UPROPERTY(EditDefaultsOnly, Category=Projectile)
+	float FireIntervalTolerance;
+
 	/** Sound to play each time we fire */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category=Gameplay)
 	USoundBase* FireSound;
@@ -100,12 +141,42 @@ protected:
 
 	FRotator OldRotation;
 
+	/** Last projectile fired by this character, while it is still in flight */
+	TWeakObjectPtr<class ATGMProjectile> InFlightProjectile;
+
+	/** Recent capsule locations, recorded on the server for lag-compensated hit validation */
+	FTGMHitboxHistory HitboxHistory;
+
+	/** World time of the last local shot */
+	float LastFireTime;
+
+	/** Id given to the next local shot */
+	uint16 NextShotId;
+
+	/** Shots registered by the owning client, oldest first. Server only. */
+	TArray<FTGMServerShot> ServerShots;
+
+	/** Shots the owning client may still register, refilled at one per MinFireInterval. Server only. */
+	float ShotAllowance;
+
+	/** World time ShotAllowance was last refilled at. Server only. */
+	float ShotAllowanceTime;
+
+	/** Forget registered shots too old for any of their claims to be accepted */
+	void PruneServerShots();
+
 public:
 	/** Returns Mesh1P subobject **/
 	USkeletalMeshComponent* GetMesh1P() const { return Mesh1P; }
 	/** Returns FirstPersonCameraComponent subobject **/
 	UCameraComponent* GetFirstPersonCameraComponent() const { return FirstPersonCameraComponent; }
+	/** Returns HealthComponent subobject **/
+	class UTGMHealthComponent* GetHealthComponent() const { return HealthComponent; }
 
 	FRotator GetOldRotation() const { return OldRotation; }
+	/** Returns the projectile currently in flight, if any **/
+	class ATGMProjectile* GetInFlightProjectile() const;
+	/** Returns the recorded capsule history **/
+	const FTGMHitboxHistory& GetHitboxHistory() const { return HitboxHistory; }
 };
 
@@ -0,0 +1,318 @@
+#include "TGMExplosionDamage.h"
+#include "TGMHealthComponent.h"
+#include "TGM.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "UObject/Package.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTGMDamage, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Explosion Damage Gather"), STAT_TGMDamageGather, STATGROUP_TGM);
+DECLARE_CYCLE_STAT(TEXT("Explosion Damage Compute"), STAT_TGMDamageCompute, STATGROUP_TGM);
+DECLARE_CYCLE_STAT(TEXT("Explosion Damage Commit"), STAT_TGMDamageCommit, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosions"), STAT_TGMExplosions, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Explosion Hits"), STAT_TGMExplosionHits, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Damage Events"), STAT_TGMDamageEvents, STATGROUP_TGM);
+
+void FTGMDamageBatch::SetNumExplosions(int32 NewNum)
+{
+	for (TArray<float>* Array : { &ExplosionX, &ExplosionY, &ExplosionZ, &ExplosionRadius, &ExplosionInnerRadius,
+		&ExplosionBaseDamage, &ExplosionMinimumDamage, &ExplosionFalloff })
+	{
+		Array->SetNumUninitialized(NewNum, false);
+	}
+
+	ExplosionTarget.SetNumUninitialized(NewNum, false);
+}
+
+void FTGMDamageBatch::SetNumTargets(int32 NewNum)
+{
+	for (TArray<float>* Array : { &TargetX, &TargetY, &TargetZ, &TargetHitRadius, &TotalDamage })
+	{
+		Array->SetNumUninitialized(NewNum, false);
+	}
+
+	NumHits.SetNumUninitialized(NewNum, false);
+	LargestExplosion.SetNumUninitialized(NewNum, false);
+}
+
+void TGMExplosionDamage::ComputeDamage(FTGMDamageBatch& Batch)
+{
+	const int32 NumExplosions = Batch.NumExplosions();
+
+	ParallelFor(Batch.NumTargets(), [&Batch, NumExplosions](int32 Target)
+	{
+		const float X = Batch.TargetX[Target];
+		const float Y = Batch.TargetY[Target];
+		const float Z = Batch.TargetZ[Target];
+		const float HitRadius = Batch.TargetHitRadius[Target];
+
+		float TotalDamage = 0.0f;
+		float LargestDamage = 0.0f;
+		int32 NumHits = 0;
+		int32 LargestExplosion = INDEX_NONE;
+
+		for (int32 Explosion = 0; Explosion < NumExplosions; Explosion++)
+		{
+			const int32 ExplosionTarget = Batch.ExplosionTarget[Explosion];
+			if (ExplosionTarget != INDEX_NONE && ExplosionTarget != Target)
+			{
+				continue;
+			}
+
+			const float DX = Batch.ExplosionX[Explosion] - X;
+			const float DY = Batch.ExplosionY[Explosion] - Y;
+			const float DZ = Batch.ExplosionZ[Explosion] - Z;
+			const float Radius = Batch.ExplosionRadius[Explosion];
+			const float ReachSq = FMath::Square(Radius + HitRadius);
+			const float DistanceSq = DX * DX + DY * DY + DZ * DZ;
+
+			if (DistanceSq >= ReachSq)
+			{
+				continue;
+			}
+
+			// Falloff from full damage at the inner radius to minimum damage at the outer radius
+			const float InnerRadius = Batch.ExplosionInnerRadius[Explosion];
+			const float Distance = FMath::Max(0.0f, FMath::Sqrt(DistanceSq) - HitRadius);
+			const float Alpha = FMath::Clamp((Distance - InnerRadius) / FMath::Max(Radius - InnerRadius, KINDA_SMALL_NUMBER), 0.0f, 1.0f);
+			const float Damage = FMath::Lerp(Batch.ExplosionBaseDamage[Explosion], Batch.ExplosionMinimumDamage[Explosion], FMath::Pow(Alpha, Batch.ExplosionFalloff[Explosion]));
+
+			TotalDamage += Damage;
+			NumHits++;
+
+			// The first explosion to reach the target counts as the largest even at zero damage, so hits always have one
+			if (LargestExplosion == INDEX_NONE || Damage > LargestDamage)
+			{
+				LargestDamage = Damage;
+				LargestExplosion = Explosion;
+			}
+		}
+
+		Batch.TotalDamage[Target] = TotalDamage;
+		Batch.NumHits[Target] = NumHits;
+		Batch.LargestExplosion[Target] = LargestExplosion;
+	});
+}
+
+int32 TGMExplosionDamage::CommitDamage(const FTGMDamageBatch& Batch, TArrayView<UTGMHealthComponent* const> Damageables, TArrayView<const FTGMExplosion> Explosions, int32& OutNumHits)
+{
+	int32 NumEvents = 0;
+	OutNumHits = 0;
+
+	for (int32 i = 0; i < Damageables.Num(); i++)
+	{
+		if (Batch.NumHits[i] == 0 || Batch.TotalDamage[i] <= 0.0f || !IsValid(Damageables[i]))
+		{
+			continue;
+		}
+
+		AActor* Instigator = Explosions[Batch.LargestExplosion[i]].Instigator.Get();
+		Damageables[i]->ApplyDamage(Batch.TotalDamage[i], Instigator);
+
+		OutNumHits += Batch.NumHits[i];
+		NumEvents++;
+	}
+
+	return NumEvents;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UTGMExplosionDamageSubsystem
+
+void UTGMExplosionDamageSubsystem::QueueExplosion(const FTGMExplosion& Explosion)
+{
+	PendingExplosions.Add(Explosion);
+}
+
+void UTGMExplosionDamageSubsystem::RegisterDamageable(UTGMHealthComponent* HealthComponent)
+{
+	Damageables.AddUnique(HealthComponent);
+}
+
+void UTGMExplosionDamageSubsystem::UnregisterDamageable(UTGMHealthComponent* HealthComponent)
+{
+	// Keep registration order, it is the order damage is committed in
+	Damageables.RemoveSingle(HealthComponent);
+}
+
+bool UTGMExplosionDamageSubsystem::IsTickable() const
+{
+	return !IsTemplate() && PendingExplosions.Num() > 0;
+}
+
+TStatId UTGMExplosionDamageSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTGMExplosionDamageSubsystem, STATGROUP_Tickables);
+}
+
+void UTGMExplosionDamageSubsystem::Tick(float DeltaTime)
+{
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TGMDamageGather);
+
+		Batch.SetNumExplosions(PendingExplosions.Num());
+		for (int32 i = 0; i < PendingExplosions.Num(); i++)
+		{
+			const FTGMExplosion& Explosion = PendingExplosions[i];
+			Batch.ExplosionX[i] = Explosion.Location.X;
+			Batch.ExplosionY[i] = Explosion.Location.Y;
+			Batch.ExplosionZ[i] = Explosion.Location.Z;
+			Batch.ExplosionRadius[i] = Explosion.Radius;
+			Batch.ExplosionInnerRadius[i] = Explosion.InnerRadius;
+			Batch.ExplosionBaseDamage[i] = Explosion.BaseDamage;
+			Batch.ExplosionMinimumDamage[i] = Explosion.MinimumDamage;
+			Batch.ExplosionFalloff[i] = Explosion.DamageFalloff;
+		}
+
+		// Dead and ownerless health components can't take damage
+		BatchDamageables.Reset();
+		for (const TWeakObjectPtr<UTGMHealthComponent>& Damageable : Damageables)
+		{
+			UTGMHealthComponent* HealthComponent = Damageable.Get();
+			if (HealthComponent != nullptr && HealthComponent->GetOwner() != nullptr && !HealthComponent->IsDead())
+			{
+				BatchDamageables.Add(HealthComponent);
+			}
+		}
+
+		Batch.SetNumTargets(BatchDamageables.Num());
+		for (int32 i = 0; i < BatchDamageables.Num(); i++)
+		{
+			const FVector Location = BatchDamageables[i]->GetOwner()->GetActorLocation();
+			Batch.TargetX[i] = Location.X;
+			Batch.TargetY[i] = Location.Y;
+			Batch.TargetZ[i] = Location.Z;
+			Batch.TargetHitRadius[i] = BatchDamageables[i]->GetHitRadius();
+		}
+
+		// Resolve targeted explosions to their damageable, those whose target can't take damage reach nobody
+		for (int32 i = 0; i < PendingExplosions.Num(); i++)
+		{
+			const FTGMExplosion& Explosion = PendingExplosions[i];
+			Batch.ExplosionTarget[i] = INDEX_NONE;
+
+			if (!Explosion.Target.IsExplicitlyNull())
+			{
+				const AActor* Target = Explosion.Target.Get();
+				const int32 TargetIndex = BatchDamageables.IndexOfByPredicate([Target](const UTGMHealthComponent* HealthComponent)
+				{
+					return Target != nullptr && HealthComponent->GetOwner() == Target;
+				});
+
+				Batch.ExplosionTarget[i] = (TargetIndex != INDEX_NONE) ? TargetIndex : BatchDamageables.Num();
+			}
+		}
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TGMDamageCompute);
+		TGMExplosionDamage::ComputeDamage(Batch);
+	}
+
+	{
+		SCOPE_CYCLE_COUNTER(STAT_TGMDamageCommit);
+
+		// Commit in registration order
+		int32 NumHits = 0;
+		const int32 NumEvents = TGMExplosionDamage::CommitDamage(Batch, BatchDamageables, PendingExplosions, NumHits);
+
+		INC_DWORD_STAT_BY(STAT_TGMExplosions, PendingExplosions.Num());
+		INC_DWORD_STAT_BY(STAT_TGMExplosionHits, NumHits);
+		INC_DWORD_STAT_BY(STAT_TGMDamageEvents, NumEvents);
+	}
+
+	PendingExplosions.Reset();
+	BatchDamageables.Reset();
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static void BenchExplosionDamage(const TArray<FString>& Args)
+{
+	const int32 NumExplosions = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 200;
+	const int32 NumTargets = (Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 5000;
+	const int32 NumIterations = 20;
+
+	if (NumExplosions <= 0 || NumTargets <= 0)
+	{
+		UE_LOG(LogTGMDamage, Warning, TEXT("Usage: TGM.BenchExplosionDamage [NumExplosions] [NumTargets]"));
+		return;
+	}
+
+	// Scatter explosions and damageables over a 50m square, with the projectile's default radius
+	FRandomStream Random(1337);
+	FTGMDamageBatch Batch;
+	Batch.SetNumExplosions(NumExplosions);
+	Batch.SetNumTargets(NumTargets);
+
+	TArray<FTGMExplosion> Explosions;
+	Explosions.SetNum(NumExplosions);
+
+	for (int32 i = 0; i < NumExplosions; i++)
+	{
+		Batch.ExplosionX[i] = Random.FRandRange(-2500.0f, 2500.0f);
+		Batch.ExplosionY[i] = Random.FRandRange(-2500.0f, 2500.0f);
+		Batch.ExplosionZ[i] = Random.FRandRange(0.0f, 200.0f);
+		Batch.ExplosionRadius[i] = 300.0f;
+		Batch.ExplosionInnerRadius[i] = 50.0f;
+		Batch.ExplosionBaseDamage[i] = 100.0f;
+		Batch.ExplosionMinimumDamage[i] = 10.0f;
+		Batch.ExplosionFalloff[i] = 1.0f;
+		Batch.ExplosionTarget[i] = INDEX_NONE;
+	}
+
+	// Real health components, so the commit runs the same damage and death events as in game. They are not attached to actors.
+	TArray<UTGMHealthComponent*> Damageables;
+	Damageables.SetNum(NumTargets);
+
+	for (int32 i = 0; i < NumTargets; i++)
+	{
+		Damageables[i] = NewObject<UTGMHealthComponent>(GetTransientPackage());
+		Batch.TargetX[i] = Random.FRandRange(-2500.0f, 2500.0f);
+		Batch.TargetY[i] = Random.FRandRange(-2500.0f, 2500.0f);
+		Batch.TargetZ[i] = 100.0f;
+		Batch.TargetHitRadius[i] = Damageables[i]->GetHitRadius();
+	}
+
+	// Health is reset every iteration so every iteration commits the same events
+	double ComputeTime = 0.0;
+	double CommitTime = 0.0;
+	int32 NumHits = 0;
+	int32 NumEvents = 0;
+
+	for (int32 Iteration = 0; Iteration < NumIterations; Iteration++)
+	{
+		for (UTGMHealthComponent* Damageable : Damageables)
+		{
+			Damageable->ResetHealth();
+		}
+
+		const double ComputeStart = FPlatformTime::Seconds();
+		TGMExplosionDamage::ComputeDamage(Batch);
+		const double CommitStart = FPlatformTime::Seconds();
+		NumEvents = TGMExplosionDamage::CommitDamage(Batch, Damageables, Explosions, NumHits);
+
+		CommitTime += FPlatformTime::Seconds() - CommitStart;
+		ComputeTime += CommitStart - ComputeStart;
+	}
+
+	for (UTGMHealthComponent* Damageable : Damageables)
+	{
+		Damageable->MarkPendingKill();
+	}
+
+	const double FrameTime = (ComputeTime + CommitTime) / NumIterations;
+
+	UE_LOG(LogTGMDamage, Display, TEXT("Explosion damage: %d explosions x %d damageables, %d hits, %d damage events per frame"),
+		NumExplosions, NumTargets, NumHits, NumEvents);
+	UE_LOG(LogTGMDamage, Display, TEXT("Explosion damage: %.3f ms compute + %.3f ms commit per frame, %.0f hits/sec, %.0f damage events/sec"),
+		ComputeTime * 1000.0 / NumIterations, CommitTime * 1000.0 / NumIterations, NumHits / FrameTime, NumEvents / FrameTime);
+}
+
+static FAutoConsoleCommand BenchExplosionDamageCommand(
+	TEXT("TGM.BenchExplosionDamage"),
+	TEXT("Measures explosion damage throughput for one frame. Usage: TGM.BenchExplosionDamage [NumExplosions=200] [NumTargets=5000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchExplosionDamage));
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TGMExplosionDamage.generated.h"
+
+class UTGMHealthComponent;
+
+/**
+ * Area damage dealt by one explosion
+ */
+struct FTGMExplosion
+{
+	FVector Location;
+
+	// Radius beyond which no damage is dealt
+	float Radius;
+
+	// Radius within which full damage is dealt
+	float InnerRadius;
+
+	// Damage within InnerRadius
+	float BaseDamage;
+
+	// Damage at Radius
+	float MinimumDamage;
+
+	// Exponent of the falloff between InnerRadius and Radius, 1 is linear
+	float DamageFalloff;
+
+	// Actor credited with the damage, may be null
+	TWeakObjectPtr<AActor> Instigator;
+
+	// Only actor the explosion damages, null damages every actor in range
+	TWeakObjectPtr<AActor> Target;
+};
+
+/**
+ * Structure-of-arrays copies of a frame's explosions and damageables, plus per-damageable results
+ */
+struct TGM_API FTGMDamageBatch
+{
+	// Explosions
+	TArray<float> ExplosionX, ExplosionY, ExplosionZ;
+	TArray<float> ExplosionRadius, ExplosionInnerRadius;
+	TArray<float> ExplosionBaseDamage, ExplosionMinimumDamage, ExplosionFalloff;
+
+	// Index of the only damageable each explosion reaches, INDEX_NONE for all
+	TArray<int32> ExplosionTarget;
+
+	// Damageables
+	TArray<float> TargetX, TargetY, TargetZ, TargetHitRadius;
+
+	// Results, one per damageable: summed damage, number of explosions that reached it and which one dealt the most damage
+	TArray<float> TotalDamage;
+	TArray<int32> NumHits;
+	TArray<int32> LargestExplosion;
+
+	void SetNumExplosions(int32 NewNum);
+
+	void SetNumTargets(int32 NewNum);
+
+	int32 NumExplosions() const { return ExplosionX.Num(); }
+
+	int32 NumTargets() const { return TargetX.Num(); }
+};
+
+namespace TGMExplosionDamage
+{
+	/**
+	 * Compute the damage every explosion deals to every damageable, in parallel over damageables.
+	 * Each damageable sums explosions in order, so results don't depend on thread scheduling.
+	 */
+	TGM_API void ComputeDamage(FTGMDamageBatch& Batch);
+
+	/**
+	 * Apply computed damage to the batch's health components in batch order, crediting the explosion that dealt the most.
+	 * Components reached only by zero damage are skipped.
+	 * Damage events may destroy actors, so components are re-checked. Returns the number of damage events.
+	 */
+	TGM_API int32 CommitDamage(const FTGMDamageBatch& Batch, TArrayView<UTGMHealthComponent* const> Damageables, TArrayView<const FTGMExplosion> Explosions, int32& OutNumHits);
+}
+
+/**
+ * Collects a frame's explosions and applies their damage to all health components in one batch:
+ * a parallel falloff pass followed by a single game-thread commit in registration order.
+ */
+UCLASS()
+class TGM_API UTGMExplosionDamageSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+	/** Queue an explosion, its damage is applied at the end of the frame */
+	void QueueExplosion(const FTGMExplosion& Explosion);
+
+	void RegisterDamageable(UTGMHealthComponent* HealthComponent);
+
+	void UnregisterDamageable(UTGMHealthComponent* HealthComponent);
+
+private:
+	TArray<FTGMExplosion> PendingExplosions;
+
+	TArray<TWeakObjectPtr<UTGMHealthComponent>> Damageables;
+
+	// Damageables gathered into the batch this frame, in batch order
+	TArray<UTGMHealthComponent*> BatchDamageables;
+
+	// Copy of PendingExplosions and BatchDamageables, kept between frames so its arrays keep their allocations
+	FTGMDamageBatch Batch;
+};
@@ -3,7 +3,15 @@
 #include "TGMGameMode.h"
 #include "TGMHUD.h"
 #include "TGMCharacter.h"
+#include "TGMProjectile.h"
+#include "TGM.h"
 #include "UObject/ConstructorHelpers.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTGMGameMode, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Validate Hit Claim"), STAT_TGMValidateHitClaim, STATGROUP_TGM);
 
 ATGMGameMode::ATGMGameMode()
 	: Super()
@@ -14,4 +22,153 @@ ATGMGameMode::ATGMGameMode()
 
 	// use our custom HUD class
 	HUDClass = ATGMHUD::StaticClass();
+
+	// Lag compensation defaults
+	MaxRewindTime = 0.5f;
+	HitValidationTolerance = 20.0f;
+}
+
+bool ATGMGameMode::ValidateHitClaim(const ATGMCharacter* Reporter, const FTGMHitClaim& Claim, float ShotFireTime, FVector& OutRewoundTargetLocation) const
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMValidateHitClaim);
+
+	// Characters can't claim hits on themselves, and need a projectile to claim anything
+	if (Reporter == nullptr || Claim.Target == nullptr || Claim.Target == Reporter || Reporter->ProjectileClass == nullptr)
+	{
+		return false;
+	}
+
+	const FTGMHitValidationParams Params = MakeHitValidationParams(Reporter->ProjectileClass, GetWorld()->GetTimeSeconds(), ShotFireTime);
+	return ValidateRewoundHitClaim(Reporter->GetHitboxHistory(), Claim.Target->GetHitboxHistory(), Claim, Params, OutRewoundTargetLocation);
+}
+
+FTGMHitValidationParams ATGMGameMode::MakeHitValidationParams(TSubclassOf<ATGMProjectile> ProjectileClass, float Now, float ShotFireTime) const
+{
+	const ATGMProjectile* Projectile = ProjectileClass->GetDefaultObject<ATGMProjectile>();
+
+	FTGMHitValidationParams Params;
+	Params.Now = Now;
+	Params.MaxRewindTime = MaxRewindTime;
+	Params.ShotFireTime = ShotFireTime;
+	Params.ProjectileLifeSpan = Projectile->GetProjectileLifeSpan();
+	Params.MaxImpactDistance = Projectile->GetMaxFlightDistance() + HitValidationTolerance;
+	Params.ImpactRadius = Projectile->GetImpulseRadius() + HitValidationTolerance;
+
+	return Params;
+}
+
+bool ATGMGameMode::ValidateRewoundHitClaim(const FTGMHitboxHistory& ReporterHistory, const FTGMHitboxHistory& TargetHistory,
+	const FTGMHitClaim& Claim, const FTGMHitValidationParams& Params, FVector& OutRewoundTargetLocation)
+{
+	// The client's estimate of server time can run slightly ahead, treat such claims as happening now
+	const float RewindTime = FMath::Min(Claim.Timestamp, Params.Now);
+
+	// Reject claims older than the rewind window
+	if (Params.Now - RewindTime > Params.MaxRewindTime)
+	{
+		return false;
+	}
+
+	// The shot was registered up to the rewind window after it was fired, and can't hit anything after its lifespan
+	if (RewindTime < Params.ShotFireTime - Params.MaxRewindTime || RewindTime > Params.ShotFireTime + Params.ProjectileLifeSpan)
+	{
+		return false;
+	}
+
+	// The impact must be within the projectile's range of where the reporter was
+	FVector ReporterLocation;
+	if (!ReporterHistory.GetLocationAtTime(RewindTime, ReporterLocation)
+		|| FVector::DistSquared(ReporterLocation, Claim.ImpactLocation) > FMath::Square(Params.MaxImpactDistance))
+	{
+		return false;
+	}
+
+	return TargetHistory.ValidateImpact(RewindTime, Claim.ImpactLocation, Params.ImpactRadius, OutRewoundTargetLocation);
 }
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static void BenchHitValidation(const TArray<FString>& Args)
+{
+	const int32 NumPlayers = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 64;
+	const int32 NumValidations = (Args.Num() > 1) ? FCString::Atoi(*Args[1]) : 1000000;
+
+	if (NumPlayers < 2 || NumValidations <= 0)
+	{
+		UE_LOG(LogTGMGameMode, Warning, TEXT("Usage: TGM.BenchHitValidation [NumPlayers >= 2] [NumValidations]"));
+		return;
+	}
+
+	FRandomStream Random(1337);
+
+	// Fill every history with one second of wandering movement, recorded at 60Hz
+	TArray<FTGMHitboxHistory> Histories;
+	Histories.SetNum(NumPlayers);
+
+	const float Duration = FTGMHitboxHistory::Capacity * FTGMHitboxHistory::RecordInterval;
+	for (FTGMHitboxHistory& History : Histories)
+	{
+		History.Reset(55.0f, 96.0f);
+
+		FVector Location = Random.GetUnitVector() * 5000.0f;
+		for (int32 i = 0; i < FTGMHitboxHistory::Capacity; i++)
+		{
+			Location += Random.GetUnitVector() * 10.0f;
+			History.Record(i * FTGMHitboxHistory::RecordInterval, Location);
+		}
+	}
+
+	const ATGMGameMode* GameMode = GetDefault<ATGMGameMode>();
+	const TSubclassOf<ATGMProjectile> ProjectileClass = ATGMProjectile::StaticClass();
+	const float Now = Duration;
+	const float MaxRewindTime = GameMode->GetMaxRewindTime();
+
+	// Pre-generate claims so only validation is timed. Claims are up to a bit older than the rewind window and
+	// impacts are scattered around the rewound target, so some are rejected.
+	TArray<FTGMHitClaim> Claims;
+	TArray<int32> Reporters;
+	TArray<int32> Targets;
+	TArray<float> ShotFireTimes;
+	Claims.SetNum(NumValidations);
+	Reporters.SetNum(NumValidations);
+	Targets.SetNum(NumValidations);
+	ShotFireTimes.SetNum(NumValidations);
+
+	for (int32 i = 0; i < NumValidations; i++)
+	{
+		Reporters[i] = Random.RandRange(0, NumPlayers - 1);
+		Targets[i] = (Reporters[i] + Random.RandRange(1, NumPlayers - 1)) % NumPlayers;
+
+		FTGMHitClaim& Claim = Claims[i];
+		Claim.Timestamp = Now - Random.FRandRange(0.0f, FMath::Min(MaxRewindTime * 1.2f, Duration));
+		ShotFireTimes[i] = Claim.Timestamp - Random.FRandRange(0.0f, 1.0f);
+
+		FVector Location;
+		Histories[Targets[i]].GetLocationAtTime(Claim.Timestamp, Location);
+		Claim.ImpactLocation = Location + Random.GetUnitVector() * Random.FRandRange(0.0f, 400.0f);
+	}
+
+	// Each validation takes the same path as a claim from the network: projectile defaults, age and shot window,
+	// reporter range and target overlap
+	int32 NumAccepted = 0;
+	const double StartTime = FPlatformTime::Seconds();
+
+	for (int32 i = 0; i < NumValidations; i++)
+	{
+		const FTGMHitValidationParams Params = GameMode->MakeHitValidationParams(ProjectileClass, Now, ShotFireTimes[i]);
+
+		FVector RewoundTargetLocation;
+		NumAccepted += ATGMGameMode::ValidateRewoundHitClaim(Histories[Reporters[i]], Histories[Targets[i]], Claims[i], Params, RewoundTargetLocation) ? 1 : 0;
+	}
+
+	const double Elapsed = FPlatformTime::Seconds() - StartTime;
+
+	UE_LOG(LogTGMGameMode, Display, TEXT("Hit validation: %d players, %d validations (%d accepted) in %.3f ms, %.0f validations/sec"),
+		NumPlayers, NumValidations, NumAccepted, Elapsed * 1000.0, NumValidations / FMath::Max(Elapsed, 1e-9));
+}
+
+static FAutoConsoleCommand BenchHitValidationCommand(
+	TEXT("TGM.BenchHitValidation"),
+	TEXT("Measures lag-compensated hit claim validations per second. Usage: TGM.BenchHitValidation [NumPlayers=64] [NumValidations=1000000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchHitValidation));
@@ -6,6 +6,30 @@
 #include "GameFramework/GameModeBase.h"
 #include "TGMGameMode.generated.h"
 
+/**
+ * Server side limits a hit claim is checked against, from the game mode and the reporter's projectile class
+ */
+struct FTGMHitValidationParams
+{
+	// Server world time the claim is validated at
+	float Now;
+
+	// Oldest claim age accepted
+	float MaxRewindTime;
+
+	// Server world time the claim's shot was registered at
+	float ShotFireTime;
+
+	// Time after which the shot can't hit anything
+	float ProjectileLifeSpan;
+
+	// Farthest the impact may be from the reporter, tolerance included
+	float MaxImpactDistance;
+
+	// Radius around the impact the target's capsule must overlap, tolerance included
+	float ImpactRadius;
+};
+
 UCLASS(minimalapi)
 class ATGMGameMode : public AGameModeBase
 {
@@ -13,6 +37,33 @@ class ATGMGameMode : public AGameModeBase
 
 public:
 	ATGMGameMode();
+
+	/**
+	 * Validates a client reported hit against the target's hitbox, rewound to the claim's timestamp.
+	 * The explosion radius and range come from the reporter's projectile class, never from the client.
+	 * The claim's timestamp must fall within the flight of the shot the server registered at ShotFireTime.
+	 * On success, OutRewoundTargetLocation is where the server had the target at the claim's timestamp.
+	 */
+	bool ValidateHitClaim(const class ATGMCharacter* Reporter, const struct FTGMHitClaim& Claim, float ShotFireTime, FVector& OutRewoundTargetLocation) const;
+
+	/** Returns the limits claims for a shot of the given projectile class are checked against */
+	FTGMHitValidationParams MakeHitValidationParams(TSubclassOf<class ATGMProjectile> ProjectileClass, float Now, float ShotFireTime) const;
+
+	/** Checks a claim against the reporter's and target's rewound hitboxes, without any actor lookups */
+	static bool ValidateRewoundHitClaim(const class FTGMHitboxHistory& ReporterHistory, const class FTGMHitboxHistory& TargetHistory,
+		const struct FTGMHitClaim& Claim, const FTGMHitValidationParams& Params, FVector& OutRewoundTargetLocation);
+
+	/** Returns the oldest claim age, in seconds, the server accepts */
+	float GetMaxRewindTime() const { return MaxRewindTime; }
+
+protected:
+	/** Oldest claim age, in seconds, the server accepts */
+	UPROPERTY(EditDefaultsOnly, Category = Network)
+	float MaxRewindTime;
+
+	/** Extra distance, in cm, a claimed impact may be away from the rewound hitbox */
+	UPROPERTY(EditDefaultsOnly, Category = Network)
+	float HitValidationTolerance;
 };
 
 
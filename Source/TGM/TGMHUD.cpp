@@ -1,19 +1,178 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "TGMHUD.h"
+#include "TGM.h"
+#include "TGMCharacter.h"
+#include "TGMProjectile.h"
 #include "Engine/Canvas.h"
 #include "Engine/Texture2D.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "Components/SceneCaptureComponent2D.h"
+#include "Camera/CameraComponent.h"
+#include "Misc/App.h"
 #include "TextureResource.h"
 #include "CanvasItem.h"
 #include "UObject/ConstructorHelpers.h"
 
+DECLARE_CYCLE_STAT(TEXT("TV Monitor Capture"), STAT_TGMMonitorCapture, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TV Monitor Captures"), STAT_TGMMonitorCaptures, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TV Monitor Width"), STAT_TGMMonitorWidth, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("TV Monitor Height"), STAT_TGMMonitorHeight, STATGROUP_TGM);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("TV Monitor Update Rate"), STAT_TGMMonitorUpdateRate, STATGROUP_TGM);
+
 ATGMHUD::ATGMHUD()
 {
 	// Set the crosshair texture
 	static ConstructorHelpers::FObjectFinder<UTexture2D> CrosshairTexObj(TEXT("/Game/FirstPerson/Textures/FirstPersonCrosshair"));
 	CrosshairTex = CrosshairTexObj.Object;
+
+	// The monitor capture is throttled manually from Tick
+	PrimaryActorTick.bCanEverTick = true;
+
+	// Monitor defaults: a small, low rate feed in the top right corner
+	bMonitorEnabled = true;
+	MonitorResolution = FIntPoint(320, 180);
+	MinMonitorResolutionScale = 0.5f;
+	MonitorUpdateRate = 20.0f;
+	MinMonitorUpdateRate = 5.0f;
+	MonitorFrameBudgetMs = 16.6f;
+	MonitorLODDistanceFactor = 2.0f;
+	MonitorScreenWidth = 0.25f;
+	MonitorScreenOffset = FVector2D(20.0f, 20.0f);
+
+	MonitorResolutionScale = 1.0f;
+	SmoothedFrameTime = 0.0f;
+	MonitorCaptureTimeLeft = 0.0f;
+	MonitorResizeCooldown = 0.0f;
+	bMonitorHasFeed = false;
+
+	// Create the monitor scene capture. It never captures on its own, and skips the most expensive features.
+	MonitorCapture = CreateDefaultSubobject<USceneCaptureComponent2D>(TEXT("MonitorCapture"));
+	MonitorCapture->bCaptureEveryFrame = false;
+	MonitorCapture->bCaptureOnMovement = false;
+	MonitorCapture->CaptureSource = ESceneCaptureSource::SCS_FinalColorLDR;
+	MonitorCapture->ShowFlags.SetMotionBlur(false);
+	MonitorCapture->ShowFlags.SetAmbientOcclusion(false);
+	MonitorCapture->ShowFlags.SetScreenSpaceReflections(false);
+	RootComponent = MonitorCapture;
+}
+
+void ATGMHUD::BeginPlay()
+{
+	Super::BeginPlay();
+
+	MonitorRenderTarget = NewObject<UTextureRenderTarget2D>(this, TEXT("MonitorRenderTarget"));
+	MonitorRenderTarget->InitAutoFormat(MonitorResolution.X, MonitorResolution.Y);
+
+	MonitorCapture->TextureTarget = MonitorRenderTarget;
+	MonitorCapture->LODDistanceFactor = MonitorLODDistanceFactor;
 }
 
+void ATGMHUD::SetMonitorEnabled(bool bEnabled)
+{
+	bMonitorEnabled = bEnabled;
+	bMonitorHasFeed = false;
+}
+
+void ATGMHUD::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	UCameraComponent* Camera = bMonitorEnabled ? GetMonitorCamera() : nullptr;
+	if (Camera == nullptr || MonitorRenderTarget == nullptr)
+	{
+		bMonitorHasFeed = false;
+		return;
+	}
+
+	// Budget against real frame time, time dilation should not change the monitor cost
+	UpdateMonitorBudget(FApp::GetDeltaTime());
+
+	MonitorCaptureTimeLeft -= FApp::GetDeltaTime();
+
+	// Capture right away when the feed has just appeared, otherwise at the throttled rate
+	if (!bMonitorHasFeed || MonitorCaptureTimeLeft <= 0.0f)
+	{
+		CaptureMonitor(Camera);
+
+		const float CurrentUpdateRate = FMath::Max(MinMonitorUpdateRate, MonitorUpdateRate * FMath::Min(1.0f, MonitorFrameBudgetMs / FMath::Max(SmoothedFrameTime * 1000.0f, KINDA_SMALL_NUMBER)));
+		SET_FLOAT_STAT(STAT_TGMMonitorUpdateRate, CurrentUpdateRate);
+
+		// Carry the overshoot over, but never queue up more than one capture
+		MonitorCaptureTimeLeft = FMath::Max(0.0f, MonitorCaptureTimeLeft + 1.0f / CurrentUpdateRate);
+	}
+}
+
+UCameraComponent* ATGMHUD::GetMonitorCamera() const
+{
+	APawn* Pawn = GetOwningPawn();
+
+	// While guiding, the main view belongs to the missile so the monitor shows the shooter
+	if (ATGMProjectile* Projectile = Cast<ATGMProjectile>(Pawn))
+	{
+		ATGMCharacter* Shooter = Projectile->GetPawnOwner();
+		return (Shooter != nullptr) ? Shooter->GetFirstPersonCameraComponent() : nullptr;
+	}
+
+	// Otherwise show the feed of a missile still in flight
+	if (ATGMCharacter* Character = Cast<ATGMCharacter>(Pawn))
+	{
+		ATGMProjectile* Projectile = Character->GetInFlightProjectile();
+		return (Projectile != nullptr) ? Projectile->GetProjectileCamera() : nullptr;
+	}
+
+	return nullptr;
+}
+
+void ATGMHUD::UpdateMonitorBudget(float RealDeltaSeconds)
+{
+	SmoothedFrameTime = (SmoothedFrameTime > 0.0f) ? FMath::Lerp(SmoothedFrameTime, RealDeltaSeconds, 0.1f) : RealDeltaSeconds;
+
+	MonitorResizeCooldown -= RealDeltaSeconds;
+	if (MonitorResizeCooldown > 0.0f)
+	{
+		return;
+	}
+
+	// Step the resolution down when clearly over budget and back up when clearly under it.
+	// Resizing reallocates the render target, so it uses hysteresis and a cooldown.
+	const float BudgetRatio = (SmoothedFrameTime * 1000.0f) / MonitorFrameBudgetMs;
+	float NewScale = MonitorResolutionScale;
+
+	if (BudgetRatio > 1.2f)
+	{
+		NewScale = FMath::Max(MinMonitorResolutionScale, MonitorResolutionScale - 0.25f);
+	}
+	else if (BudgetRatio < 0.8f)
+	{
+		NewScale = FMath::Min(1.0f, MonitorResolutionScale + 0.25f);
+	}
+
+	if (NewScale != MonitorResolutionScale)
+	{
+		MonitorResolutionScale = NewScale;
+		MonitorRenderTarget->ResizeTarget(FMath::Max(1, FMath::RoundToInt(MonitorResolution.X * NewScale)), FMath::Max(1, FMath::RoundToInt(MonitorResolution.Y * NewScale)));
+		MonitorResizeCooldown = 1.0f;
+	}
+}
+
+void ATGMHUD::CaptureMonitor(UCameraComponent* Camera)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMMonitorCapture);
+
+	// Mirror the source camera, including its post-process look
+	MonitorCapture->SetWorldLocationAndRotation(Camera->GetComponentLocation(), Camera->GetComponentRotation());
+	MonitorCapture->FOVAngle = Camera->FieldOfView;
+	MonitorCapture->PostProcessSettings = Camera->PostProcessSettings;
+	MonitorCapture->PostProcessBlendWeight = Camera->PostProcessBlendWeight;
+
+	MonitorCapture->CaptureScene();
+	bMonitorHasFeed = true;
+
+	INC_DWORD_STAT(STAT_TGMMonitorCaptures);
+	SET_DWORD_STAT(STAT_TGMMonitorWidth, MonitorRenderTarget->SizeX);
+	SET_DWORD_STAT(STAT_TGMMonitorHeight, MonitorRenderTarget->SizeY);
+}
 
 void ATGMHUD::DrawHUD()
 {
@@ -32,4 +191,21 @@ void ATGMHUD::DrawHUD()
 	FCanvasTileItem TileItem( CrosshairDrawPosition, CrosshairTex->Resource, FLinearColor::White);
 	TileItem.BlendMode = SE_BLEND_Translucent;
 	Canvas->DrawItem( TileItem );
+
+	if (bMonitorHasFeed)
+	{
+		DrawMonitor();
+	}
+}
+
+void ATGMHUD::DrawMonitor()
+{
+	// Keep the full resolution aspect ratio on screen, whatever resolution is currently captured
+	const float Width = Canvas->ClipX * MonitorScreenWidth;
+	const float Height = Width * MonitorResolution.Y / FMath::Max(1, MonitorResolution.X);
+	const FVector2D MonitorPosition(Canvas->ClipX - Width - MonitorScreenOffset.X, MonitorScreenOffset.Y);
+
+	FCanvasTileItem MonitorItem(MonitorPosition, MonitorRenderTarget->Resource, FVector2D(Width, Height), FLinearColor::White);
+	MonitorItem.BlendMode = SE_BLEND_Opaque;
+	Canvas->DrawItem(MonitorItem);
 }
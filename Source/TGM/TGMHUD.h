@@ -17,6 +17,14 @@ public:
 	/** Primary draw call for the HUD */
 	virtual void DrawHUD() override;
 
+	virtual void BeginPlay() override;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+	/** Enables or disables the picture-in-picture TV monitor */
+	UFUNCTION(BlueprintCallable, Category = Monitor)
+	void SetMonitorEnabled(bool bEnabled);
+
 private:
 	/** Crosshair asset pointer */
 	class UTexture2D* CrosshairTex;
@@ -26,5 +34,76 @@ private:
 
 	UPROPERTY(EditDefaultsOnly, Category = HUD)
 	float DeltaY;
+
+	/** Scene capture rendering the picture-in-picture TV monitor feed */
+	UPROPERTY(VisibleDefaultsOnly, Category = Monitor)
+	class USceneCaptureComponent2D* MonitorCapture;
+
+	/** Render target the monitor feed is captured into */
+	UPROPERTY(Transient)
+	class UTextureRenderTarget2D* MonitorRenderTarget;
+
+	/** Whether the TV monitor is shown. It shows whichever of the shooter and missile views is not the main view. */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor)
+	bool bMonitorEnabled;
+
+	/** Monitor render target resolution at full quality */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor)
+	FIntPoint MonitorResolution;
+
+	/** Lowest fraction of MonitorResolution used when over frame budget */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor, meta = (ClampMin = "0.1", ClampMax = "1.0"))
+	float MinMonitorResolutionScale;
+
+	/** Monitor captures per second when within frame budget */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor, meta = (ClampMin = "1.0"))
+	float MonitorUpdateRate;
+
+	/** Lowest monitor captures per second when over frame budget */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor, meta = (ClampMin = "1.0"))
+	float MinMonitorUpdateRate;
+
+	/** Frame time, in ms, above which the monitor reduces its update rate and resolution */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor)
+	float MonitorFrameBudgetMs;
+
+	/** LOD distance factor used by the monitor capture, higher values pick coarser LODs */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor)
+	float MonitorLODDistanceFactor;
+
+	/** Monitor width on screen, as a fraction of the viewport width */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor)
+	float MonitorScreenWidth;
+
+	/** Monitor offset from the top right corner of the viewport, in pixels */
+	UPROPERTY(EditDefaultsOnly, Category = Monitor)
+	FVector2D MonitorScreenOffset;
+
+	/** Current fraction of MonitorResolution in use */
+	float MonitorResolutionScale;
+
+	/** Smoothed real frame time, in seconds */
+	float SmoothedFrameTime;
+
+	/** Time until the next monitor capture */
+	float MonitorCaptureTimeLeft;
+
+	/** Time until the monitor resolution may change again */
+	float MonitorResizeCooldown;
+
+	/** Whether the render target holds a capture of the current feed */
+	bool bMonitorHasFeed;
+
+	/** Returns the camera the monitor should show, or null if there is nothing to show */
+	class UCameraComponent* GetMonitorCamera() const;
+
+	/** Adapt monitor update rate and resolution to the current frame time */
+	void UpdateMonitorBudget(float RealDeltaSeconds);
+
+	/** Capture the monitor feed from the given camera */
+	void CaptureMonitor(class UCameraComponent* Camera);
+
+	/** Draw the last captured monitor feed */
+	void DrawMonitor();
 };
 
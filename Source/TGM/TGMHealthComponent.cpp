@@ -0,0 +1,51 @@
+#include "TGMHealthComponent.h"
+#include "TGMExplosionDamage.h"
+#include "Engine/World.h"
+
+UTGMHealthComponent::UTGMHealthComponent()
+{
+	// Damage is applied by the explosion damage pipeline, nothing to do per frame
+	PrimaryComponentTick.bCanEverTick = false;
+
+	MaxHealth = 100.0f;
+	HitRadius = 50.0f;
+	Health = MaxHealth;
+}
+
+void UTGMHealthComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	ResetHealth();
+
+	if (UTGMExplosionDamageSubsystem* ExplosionDamage = GetWorld()->GetSubsystem<UTGMExplosionDamageSubsystem>())
+	{
+		ExplosionDamage->RegisterDamageable(this);
+	}
+}
+
+void UTGMHealthComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTGMExplosionDamageSubsystem* ExplosionDamage = GetWorld()->GetSubsystem<UTGMExplosionDamageSubsystem>())
+	{
+		ExplosionDamage->UnregisterDamageable(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTGMHealthComponent::ApplyDamage(float Damage, AActor* DamageInstigator)
+{
+	if (IsDead() || Damage <= 0.0f)
+	{
+		return;
+	}
+
+	Health = FMath::Max(0.0f, Health - Damage);
+	OnDamaged.Broadcast(this, Damage, DamageInstigator);
+
+	if (IsDead())
+	{
+		OnDeath.Broadcast(this, DamageInstigator);
+	}
+}
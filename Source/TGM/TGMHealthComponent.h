@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "TGMHealthComponent.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FTGMOnDamagedSignature, class UTGMHealthComponent*, HealthComponent, float, Damage, AActor*, DamageInstigator);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTGMOnDeathSignature, class UTGMHealthComponent*, HealthComponent, AActor*, Killer);
+
+/**
+ * Health of a damageable actor. Registers with the explosion damage pipeline while in play.
+ */
+UCLASS(ClassGroup = (TGM), meta = (BlueprintSpawnableComponent))
+class TGM_API UTGMHealthComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UTGMHealthComponent();
+
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	/** Subtract damage and fire the damage and death events */
+	void ApplyDamage(float Damage, AActor* DamageInstigator);
+
+	/** Restore health to MaxHealth, without firing events */
+	void ResetHealth() { Health = MaxHealth; }
+
+	UFUNCTION(BlueprintCallable, Category = Health)
+	float GetHealth() const { return Health; }
+
+	UFUNCTION(BlueprintCallable, Category = Health)
+	bool IsDead() const { return Health <= 0.0f; }
+
+	float GetHitRadius() const { return HitRadius; }
+
+	/** Called whenever damage is applied */
+	UPROPERTY(BlueprintAssignable, Category = Health)
+	FTGMOnDamagedSignature OnDamaged;
+
+	/** Called once, when health reaches zero */
+	UPROPERTY(BlueprintAssignable, Category = Health)
+	FTGMOnDeathSignature OnDeath;
+
+protected:
+	// Health at spawn
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Health)
+	float MaxHealth;
+
+	// Radius around the owner's location within which explosions count as reaching it
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Health)
+	float HitRadius;
+
+	// Current health
+	UPROPERTY(VisibleInstanceOnly, BlueprintReadOnly, Category = Health)
+	float Health;
+};
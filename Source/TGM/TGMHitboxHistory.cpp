@@ -0,0 +1,94 @@
+#include "TGMHitboxHistory.h"
+#include "TGM.h"
+
+static_assert((FTGMHitboxHistory::Capacity & (FTGMHitboxHistory::Capacity - 1)) == 0, "Hitbox history capacity must be a power of two");
+
+FTGMHitboxHistory::FTGMHitboxHistory()
+{
+	Reset(0.0f, 0.0f);
+}
+
+void FTGMHitboxHistory::Reset(float InCapsuleRadius, float InCapsuleHalfHeight)
+{
+	Head = 0;
+	NumSnapshots = 0;
+	CapsuleRadius = InCapsuleRadius;
+	CapsuleHalfHeight = InCapsuleHalfHeight;
+}
+
+void FTGMHitboxHistory::Record(float Time, const FVector& Location)
+{
+	// Keep overwriting the newest snapshot until it is a full record interval past the one before it,
+	// so the history is evenly spaced but always ends at the latest location
+	if (NumSnapshots > 1 && GetSnapshot(NumSnapshots - 1).Time - GetSnapshot(NumSnapshots - 2).Time < RecordInterval - KINDA_SMALL_NUMBER)
+	{
+		Snapshots[(Head - 1) & (Capacity - 1)] = { Time, Location };
+		return;
+	}
+
+	Snapshots[Head] = { Time, Location };
+	Head = (Head + 1) & (Capacity - 1);
+	NumSnapshots = FMath::Min(NumSnapshots + 1, Capacity);
+}
+
+bool FTGMHitboxHistory::GetLocationAtTime(float Time, FVector& OutLocation) const
+{
+	if (NumSnapshots == 0 || Time < GetSnapshot(0).Time)
+	{
+		return false;
+	}
+
+	// Binary search for the first snapshot at or after Time
+	int32 Low = 0;
+	int32 High = NumSnapshots - 1;
+
+	if (Time >= GetSnapshot(High).Time)
+	{
+		OutLocation = GetSnapshot(High).Location;
+		return true;
+	}
+
+	while (Low < High)
+	{
+		const int32 Mid = (Low + High) / 2;
+		if (GetSnapshot(Mid).Time < Time)
+		{
+			Low = Mid + 1;
+		}
+		else
+		{
+			High = Mid;
+		}
+	}
+
+	const FTGMHitboxSnapshot& After = GetSnapshot(Low);
+	if (Low == 0)
+	{
+		OutLocation = After.Location;
+		return true;
+	}
+
+	const FTGMHitboxSnapshot& Before = GetSnapshot(Low - 1);
+	const float Alpha = (Time - Before.Time) / FMath::Max(After.Time - Before.Time, KINDA_SMALL_NUMBER);
+	OutLocation = FMath::Lerp(Before.Location, After.Location, Alpha);
+	return true;
+}
+
+bool FTGMHitboxHistory::ValidateImpact(float Time, const FVector& Impact, float Radius, FVector& OutLocation) const
+{
+	if (!GetLocationAtTime(Time, OutLocation))
+	{
+		return false;
+	}
+
+	// Distance from the impact to the capsule's inner segment, compared against the combined radii
+	const FVector SegmentOffset(0.0f, 0.0f, FMath::Max(0.0f, CapsuleHalfHeight - CapsuleRadius));
+	const float Distance = FMath::PointDistToSegment(Impact, OutLocation - SegmentOffset, OutLocation + SegmentOffset);
+
+	return Distance <= CapsuleRadius + Radius;
+}
+
+float FTGMHitboxHistory::GetOldestTime() const
+{
+	return (NumSnapshots > 0) ? GetSnapshot(0).Time : 0.0f;
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TGMHitboxHistory.generated.h"
+
+/**
+ * Impact reported by a client, validated by the server against the target's rewound hitbox
+ */
+USTRUCT()
+struct FTGMHitClaim
+{
+	GENERATED_BODY()
+
+	// Character the client claims to have hit
+	UPROPERTY()
+	class ATGMCharacter* Target = nullptr;
+
+	// World location of the impact or explosion center
+	UPROPERTY()
+	FVector_NetQuantize ImpactLocation;
+
+	// Server world time at which the client saw the impact
+	UPROPERTY()
+	float Timestamp = 0.0f;
+
+	// Shot the impact belongs to, as registered with ATGMCharacter::ServerRegisterShot
+	UPROPERTY()
+	uint16 ShotId = 0;
+};
+
+/**
+ * Position of a capsule hitbox at a point in time. Capsules stay upright, so rotation is not stored.
+ */
+struct FTGMHitboxSnapshot
+{
+	float Time;
+	FVector Location;
+};
+
+/**
+ * Fixed-size ring buffer of recent capsule positions, used to rewind a character for hit validation.
+ * Snapshots are stored inline, so validating a claim touches one contiguous block of memory.
+ */
+class FTGMHitboxHistory
+{
+public:
+	// Number of snapshots kept, must be a power of two
+	static constexpr int32 Capacity = 64;
+
+	// Minimum time between recorded snapshots, so the window length does not depend on frame rate
+	static constexpr float RecordInterval = 1.0f / 60.0f;
+
+	FTGMHitboxHistory();
+
+	// Clear all snapshots and set the capsule dimensions
+	void Reset(float InCapsuleRadius, float InCapsuleHalfHeight);
+
+	// Record the capsule location at the given time. Times must be increasing.
+	void Record(float Time, const FVector& Location);
+
+	// Returns the capsule location at the given time, interpolated between snapshots
+	bool GetLocationAtTime(float Time, FVector& OutLocation) const;
+
+	// Whether a sphere of the given radius at Impact overlapped the capsule at the given time.
+	// OutLocation is the capsule location at that time, whenever the history covers it.
+	bool ValidateImpact(float Time, const FVector& Impact, float Radius, FVector& OutLocation) const;
+
+	// Returns the time of the oldest snapshot, or 0 if there is none
+	float GetOldestTime() const;
+
+	int32 Num() const { return NumSnapshots; }
+
+private:
+	// Returns the snapshot at a logical index, 0 being the oldest
+	const FTGMHitboxSnapshot& GetSnapshot(int32 Index) const
+	{
+		return Snapshots[(Head - NumSnapshots + Index) & (Capacity - 1)];
+	}
+
+	FTGMHitboxSnapshot Snapshots[Capacity];
+
+	// Index the next snapshot is written to
+	int32 Head;
+
+	int32 NumSnapshots;
+
+	float CapsuleRadius;
+
+	float CapsuleHalfHeight;
+};
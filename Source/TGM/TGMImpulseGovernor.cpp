@@ -0,0 +1,161 @@
+#include "TGMImpulseGovernor.h"
+#include "TGM.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/Pawn.h"
+#include "PhysicsPublic.h"
+#include "Engine/World.h"
+#include "Algo/Sort.h"
+
+DECLARE_CYCLE_STAT(TEXT("Impulse Governor"), STAT_TGMImpulseGovernor, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impulses Queued"), STAT_TGMImpulsesQueued, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Impulses Merged"), STAT_TGMImpulsesMerged, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Bodies Woken"), STAT_TGMBodiesWoken, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Wakes Deferred"), STAT_TGMWakesDeferred, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Governed Bodies Awake"), STAT_TGMGovernedBodiesAwake, STATGROUP_TGM);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Physics Step Time (ms)"), STAT_TGMPhysicsStepTime, STATGROUP_TGM);
+
+void UTGMImpulseGovernor::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	// Time the physics step, from the start of the simulation to its completion
+	if (FPhysScene* PhysScene = GetWorld()->GetPhysicsScene())
+	{
+		PreTickHandle = PhysScene->OnPhysScenePreTick.AddUObject(this, &UTGMImpulseGovernor::OnPhysScenePreTick);
+		PostTickHandle = PhysScene->OnPhysScenePostTick.AddUObject(this, &UTGMImpulseGovernor::OnPhysScenePostTick);
+	}
+}
+
+void UTGMImpulseGovernor::Deinitialize()
+{
+	if (FPhysScene* PhysScene = GetWorld()->GetPhysicsScene())
+	{
+		PhysScene->OnPhysScenePreTick.Remove(PreTickHandle);
+		PhysScene->OnPhysScenePostTick.Remove(PostTickHandle);
+	}
+
+	PendingImpulses.Empty();
+	AwakeBodies.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UTGMImpulseGovernor::IsTickable() const
+{
+	return !IsTemplate() && GetWorld() != nullptr && GetWorld()->IsGameWorld();
+}
+
+TStatId UTGMImpulseGovernor::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTGMImpulseGovernor, STATGROUP_Tickables);
+}
+
+void UTGMImpulseGovernor::QueueImpulse(UPrimitiveComponent* Component, const FVector& Impulse)
+{
+	if (Component == nullptr || !Component->IsSimulatingPhysics())
+	{
+		return;
+	}
+
+	INC_DWORD_STAT(STAT_TGMImpulsesQueued);
+
+	// Overlapping explosions on the same component are merged into a single impulse
+	if (FTGMPendingImpulse* Pending = PendingImpulses.Find(Component))
+	{
+		Pending->Impulse += Impulse;
+		INC_DWORD_STAT(STAT_TGMImpulsesMerged);
+		return;
+	}
+
+	PendingImpulses.Add(Component).Impulse = Impulse;
+}
+
+void UTGMImpulseGovernor::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMImpulseGovernor);
+
+	// Forget bodies that went back to sleep
+	AwakeBodies.RemoveAllSwap([](const TWeakObjectPtr<UPrimitiveComponent>& Body)
+	{
+		return !Body.IsValid() || !Body->IsAnyRigidBodyAwake();
+	});
+
+	// Awake bodies take their impulse right away, sleeping ones compete for this frame's wake budget
+	WakeCandidates.Reset();
+	for (auto It = PendingImpulses.CreateIterator(); It; ++It)
+	{
+		UPrimitiveComponent* Component = It.Key().Get();
+
+		if (Component == nullptr || !Component->IsSimulatingPhysics())
+		{
+			It.RemoveCurrent();
+		}
+		else if (Component->IsAnyRigidBodyAwake())
+		{
+			Component->AddImpulse(It.Value().Impulse);
+			It.RemoveCurrent();
+		}
+		else
+		{
+			// Players and deferred bodies move, so distances are measured again every frame
+			FTGMWakeCandidate& Candidate = WakeCandidates.AddDefaulted_GetRef();
+			Candidate.Component = It.Key();
+			Candidate.Impulse = It.Value().Impulse;
+			Candidate.PlayerDistanceSq = GetClosestPlayerDistanceSq(Component->GetComponentLocation());
+		}
+	}
+
+	// Wake the bodies closest to players first, the rest waits for the next frames
+	const int32 NumWakes = FMath::Min(WakeCandidates.Num(), FMath::Max(0, MaxWakesPerFrame));
+	if (NumWakes < WakeCandidates.Num())
+	{
+		Algo::Sort(WakeCandidates, [](const FTGMWakeCandidate& A, const FTGMWakeCandidate& B)
+		{
+			return A.PlayerDistanceSq < B.PlayerDistanceSq;
+		});
+	}
+
+	for (int32 i = 0; i < NumWakes; i++)
+	{
+		const FTGMWakeCandidate& Candidate = WakeCandidates[i];
+		Candidate.Component->AddImpulse(Candidate.Impulse);
+		PendingImpulses.Remove(Candidate.Component);
+		AwakeBodies.Add(Candidate.Component);
+	}
+
+	INC_DWORD_STAT_BY(STAT_TGMBodiesWoken, NumWakes);
+	SET_DWORD_STAT(STAT_TGMWakesDeferred, PendingImpulses.Num());
+	SET_DWORD_STAT(STAT_TGMGovernedBodiesAwake, AwakeBodies.Num());
+}
+
+float UTGMImpulseGovernor::GetClosestPlayerDistanceSq(const FVector& Location) const
+{
+	float ClosestDistanceSq = MAX_flt;
+
+	for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+	{
+		const APlayerController* PC = It->Get();
+		const APawn* Pawn = (PC != nullptr) ? PC->GetPawn() : nullptr;
+
+		if (Pawn != nullptr)
+		{
+			ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(Location, Pawn->GetActorLocation()));
+		}
+	}
+
+	return ClosestDistanceSq;
+}
+
+void UTGMImpulseGovernor::OnPhysScenePreTick(FPhysScene* PhysScene, float DeltaSeconds)
+{
+	PhysicsStepStartTime = FPlatformTime::Seconds();
+}
+
+void UTGMImpulseGovernor::OnPhysScenePostTick(FPhysScene* PhysScene)
+{
+	if (PhysicsStepStartTime > 0.0)
+	{
+		SET_FLOAT_STAT(STAT_TGMPhysicsStepTime, (FPlatformTime::Seconds() - PhysicsStepStartTime) * 1000.0);
+	}
+}
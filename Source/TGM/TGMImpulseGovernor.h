@@ -0,0 +1,83 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "Physics/PhysicsInterfaceDeclares.h"
+#include "TGMImpulseGovernor.generated.h"
+
+/**
+ * Impulse waiting to be applied to a component, merged from all explosions that reached it
+ */
+struct FTGMPendingImpulse
+{
+	// Sum of all impulses queued for the component. Keeps growing while the wake is deferred,
+	// so a body hit by several explosions before waking still receives all of them.
+	FVector Impulse;
+};
+
+/**
+ * Sleeping component competing for this frame's wake budget
+ */
+struct FTGMWakeCandidate
+{
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	FVector Impulse;
+
+	// Squared distance to the closest player this frame, lower is woken first
+	float PlayerDistanceSq;
+};
+
+/**
+ * Governs explosion impulses so bursts of explosions don't wake hundreds of rigid bodies in one frame.
+ * Impulses on the same component are merged, impulses on already awake bodies are applied right away,
+ * and at most MaxWakesPerFrame sleeping bodies are woken per frame, closest to a player first.
+ */
+UCLASS(config=Game)
+class TGM_API UTGMImpulseGovernor : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+	/** Queue an impulse to be applied to a component at the end of the frame */
+	void QueueImpulse(UPrimitiveComponent* Component, const FVector& Impulse);
+
+	/** Maximum number of sleeping bodies woken up per frame */
+	UPROPERTY(Config, EditAnywhere, Category = Physics)
+	int32 MaxWakesPerFrame = 32;
+
+private:
+	// Returns the squared distance from Location to the closest player pawn
+	float GetClosestPlayerDistanceSq(const FVector& Location) const;
+
+	void OnPhysScenePreTick(FPhysScene* PhysScene, float DeltaSeconds);
+
+	void OnPhysScenePostTick(FPhysScene* PhysScene);
+
+	TMap<TWeakObjectPtr<UPrimitiveComponent>, FTGMPendingImpulse> PendingImpulses;
+
+	// Bodies woken by the governor that have not gone back to sleep yet
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> AwakeBodies;
+
+	// Sleeping components with a pending impulse, rebuilt and sorted every frame
+	TArray<FTGMWakeCandidate> WakeCandidates;
+
+	// Platform time at which the current physics step started
+	double PhysicsStepStartTime = 0.0;
+
+	FDelegateHandle PreTickHandle;
+
+	FDelegateHandle PostTickHandle;
+};
@@ -0,0 +1,63 @@
+#include "TGMMissileAIController.h"
+#include "TGMMissileGuidance.h"
+#include "TGMProjectile.h"
+#include "Engine/World.h"
+
+ATGMProjectile* ATGMMissileAIController::LaunchGuidedProjectile(UWorld* World, TSubclassOf<ATGMProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Target, ATGMCharacter* Shooter)
+{
+	if (World == nullptr || ProjectileClass == nullptr)
+	{
+		return nullptr;
+	}
+
+	FActorSpawnParameters ActorSpawnParams;
+	ActorSpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButDontSpawnIfColliding;
+
+	ATGMProjectile* Projectile = World->SpawnActor<ATGMProjectile>(ProjectileClass, Location, Rotation, ActorSpawnParams);
+	if (Projectile == nullptr)
+	{
+		return nullptr;
+	}
+
+	ATGMMissileAIController* MissileController = World->SpawnActor<ATGMMissileAIController>();
+	MissileController->SetTarget(Target);
+	MissileController->SetControlRotation(Rotation);
+	MissileController->Possess(Projectile);
+
+	Projectile->FireInDirection(Rotation.Vector(), Shooter);
+
+	return Projectile;
+}
+
+void ATGMMissileAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	if (UTGMMissileGuidanceSubsystem* Guidance = GetWorld()->GetSubsystem<UTGMMissileGuidanceSubsystem>())
+	{
+		Guidance->RegisterMissile(this);
+	}
+}
+
+void ATGMMissileAIController::OnUnPossess()
+{
+	if (UTGMMissileGuidanceSubsystem* Guidance = GetWorld()->GetSubsystem<UTGMMissileGuidanceSubsystem>())
+	{
+		Guidance->UnregisterMissile(this);
+	}
+
+	Super::OnUnPossess();
+
+	// Nothing left to guide once the missile is gone
+	Destroy();
+}
+
+void ATGMMissileAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UTGMMissileGuidanceSubsystem* Guidance = GetWorld()->GetSubsystem<UTGMMissileGuidanceSubsystem>())
+	{
+		Guidance->UnregisterMissile(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Controller.h"
+#include "TGMMissileAIController.generated.h"
+
+/**
+ * Lightweight controller for AI-owned guided projectiles. It holds no per-missile logic;
+ * the guidance subsystem steers all AI missiles in one batch and writes their control rotations.
+ */
+UCLASS()
+class TGM_API ATGMMissileAIController : public AController
+{
+	GENERATED_BODY()
+
+public:
+	/**
+	 * Spawn a projectile, fire it and let a new AI controller guide it to the target
+	 * @param Shooter	Character credited with the shot, may be null for turrets
+	 */
+	static class ATGMProjectile* LaunchGuidedProjectile(UWorld* World, TSubclassOf<class ATGMProjectile> ProjectileClass, const FVector& Location, const FRotator& Rotation, AActor* Target, class ATGMCharacter* Shooter);
+
+	/** Returns the actor the missile is guided to */
+	AActor* GetTarget() const { return Target.Get(); }
+
+	/** Sets the actor the missile is guided to */
+	void SetTarget(AActor* NewTarget) { Target = NewTarget; }
+
+protected:
+	// AController interface
+	virtual void OnPossess(APawn* InPawn) override;
+	virtual void OnUnPossess() override;
+	// End of AController interface
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	// Actor the missile is guided to
+	TWeakObjectPtr<AActor> Target;
+};
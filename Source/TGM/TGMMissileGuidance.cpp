@@ -0,0 +1,403 @@
+#include "TGMMissileGuidance.h"
+#include "TGMMissileAIController.h"
+#include "TGM.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/DefaultPawn.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Math/RandomStream.h"
+#include "Math/VectorRegister.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTGMGuidance, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("AI Missile Guidance"), STAT_TGMMissileGuidance, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("AI Missiles Guided"), STAT_TGMMissilesGuided, STATGROUP_TGM);
+
+void FTGMGuidanceBatch::SetNum(int32 NewNum)
+{
+	for (TArray<float>* Array : { &MissilePosX, &MissilePosY, &MissilePosZ, &MissileVelX, &MissileVelY, &MissileVelZ,
+		&TargetPosX, &TargetPosY, &TargetPosZ, &TargetVelX, &TargetVelY, &TargetVelZ, &DirX, &DirY, &DirZ })
+	{
+		Array->SetNumUninitialized(NewNum, false);
+	}
+}
+
+void TGMMissileGuidance::ComputeProportionalNavigation(FTGMGuidanceBatch& Batch, float NavigationConstant, float MaxTurnRate, float DeltaTime)
+{
+	const int32 Num = Batch.Num();
+
+	const float* RESTRICT MPX = Batch.MissilePosX.GetData();
+	const float* RESTRICT MPY = Batch.MissilePosY.GetData();
+	const float* RESTRICT MPZ = Batch.MissilePosZ.GetData();
+	const float* RESTRICT MVX = Batch.MissileVelX.GetData();
+	const float* RESTRICT MVY = Batch.MissileVelY.GetData();
+	const float* RESTRICT MVZ = Batch.MissileVelZ.GetData();
+	const float* RESTRICT TPX = Batch.TargetPosX.GetData();
+	const float* RESTRICT TPY = Batch.TargetPosY.GetData();
+	const float* RESTRICT TPZ = Batch.TargetPosZ.GetData();
+	const float* RESTRICT TVX = Batch.TargetVelX.GetData();
+	const float* RESTRICT TVY = Batch.TargetVelY.GetData();
+	const float* RESTRICT TVZ = Batch.TargetVelZ.GetData();
+	float* RESTRICT DX = Batch.DirX.GetData();
+	float* RESTRICT DY = Batch.DirY.GetData();
+	float* RESTRICT DZ = Batch.DirZ.GetData();
+
+	const VectorRegister VecNavigationConstant = VectorSetFloat1(NavigationConstant);
+	const VectorRegister VecMaxTurnRate = VectorSetFloat1(MaxTurnRate);
+	const VectorRegister VecDeltaTime = VectorSetFloat1(DeltaTime);
+	const VectorRegister VecSmall = VectorSetFloat1(KINDA_SMALL_NUMBER);
+	const VectorRegister VecSmallSq = VectorSetFloat1(KINDA_SMALL_NUMBER * KINDA_SMALL_NUMBER);
+	const VectorRegister VecOne = VectorOne();
+
+	// Four missiles at a time in SIMD registers, the same math as the scalar loop below
+	int32 i = 0;
+	for (; i + 4 <= Num; i += 4)
+	{
+		const VectorRegister VX = VectorLoad(MVX + i);
+		const VectorRegister VY = VectorLoad(MVY + i);
+		const VectorRegister VZ = VectorLoad(MVZ + i);
+
+		// Relative position and velocity of the target
+		const VectorRegister RX = VectorSubtract(VectorLoad(TPX + i), VectorLoad(MPX + i));
+		const VectorRegister RY = VectorSubtract(VectorLoad(TPY + i), VectorLoad(MPY + i));
+		const VectorRegister RZ = VectorSubtract(VectorLoad(TPZ + i), VectorLoad(MPZ + i));
+		const VectorRegister VRX = VectorSubtract(VectorLoad(TVX + i), VX);
+		const VectorRegister VRY = VectorSubtract(VectorLoad(TVY + i), VY);
+		const VectorRegister VRZ = VectorSubtract(VectorLoad(TVZ + i), VZ);
+
+		// Line-of-sight rotation rate: (R x Vr) / |R|^2
+		const VectorRegister RangeSq = VectorMultiplyAdd(RX, RX, VectorMultiplyAdd(RY, RY, VectorMultiply(RZ, RZ)));
+		const VectorRegister InvRangeSq = VectorDivide(VecOne, VectorMax(RangeSq, VecOne));
+		const VectorRegister WX = VectorMultiply(VectorSubtract(VectorMultiply(RY, VRZ), VectorMultiply(RZ, VRY)), InvRangeSq);
+		const VectorRegister WY = VectorMultiply(VectorSubtract(VectorMultiply(RZ, VRX), VectorMultiply(RX, VRZ)), InvRangeSq);
+		const VectorRegister WZ = VectorMultiply(VectorSubtract(VectorMultiply(RX, VRY), VectorMultiply(RY, VRX)), InvRangeSq);
+
+		// Commanded acceleration: N * (W x Vm), perpendicular to the missile velocity
+		const VectorRegister AX = VectorMultiply(VecNavigationConstant, VectorSubtract(VectorMultiply(WY, VZ), VectorMultiply(WZ, VY)));
+		const VectorRegister AY = VectorMultiply(VecNavigationConstant, VectorSubtract(VectorMultiply(WZ, VX), VectorMultiply(WX, VZ)));
+		const VectorRegister AZ = VectorMultiply(VecNavigationConstant, VectorSubtract(VectorMultiply(WX, VY), VectorMultiply(WY, VX)));
+
+		// Limit the turn rate (acceleration / speed) to the missile's handling
+		const VectorRegister SpeedSq = VectorMax(VectorMultiplyAdd(VX, VX, VectorMultiplyAdd(VY, VY, VectorMultiply(VZ, VZ))), VecSmall);
+		const VectorRegister InvSpeed = VectorReciprocalSqrtAccurate(SpeedSq);
+		const VectorRegister Speed = VectorMultiply(SpeedSq, InvSpeed);
+		const VectorRegister AccelSq = VectorMultiplyAdd(AX, AX, VectorMultiplyAdd(AY, AY, VectorMultiply(AZ, AZ)));
+		const VectorRegister InvAccel = VectorReciprocalSqrtAccurate(VectorMax(AccelSq, VecSmallSq));
+		const VectorRegister AccelScale = VectorMin(VecOne, VectorMultiply(VectorMultiply(VecMaxTurnRate, Speed), InvAccel));
+
+		// Rotate the flight direction by the turn over this step
+		const VectorRegister TurnScale = VectorMultiply(VectorMultiply(AccelScale, VecDeltaTime), InvSpeed);
+		const VectorRegister NX = VectorMultiplyAdd(AX, TurnScale, VectorMultiply(VX, InvSpeed));
+		const VectorRegister NY = VectorMultiplyAdd(AY, TurnScale, VectorMultiply(VY, InvSpeed));
+		const VectorRegister NZ = VectorMultiplyAdd(AZ, TurnScale, VectorMultiply(VZ, InvSpeed));
+		const VectorRegister LengthSq = VectorMax(VectorMultiplyAdd(NX, NX, VectorMultiplyAdd(NY, NY, VectorMultiply(NZ, NZ))), VecSmall);
+		const VectorRegister InvLength = VectorReciprocalSqrtAccurate(LengthSq);
+
+		VectorStore(VectorMultiply(NX, InvLength), DX + i);
+		VectorStore(VectorMultiply(NY, InvLength), DY + i);
+		VectorStore(VectorMultiply(NZ, InvLength), DZ + i);
+	}
+
+	// Remaining missiles, one at a time
+	for (; i < Num; i++)
+	{
+		// Relative position and velocity of the target
+		const float RX = TPX[i] - MPX[i];
+		const float RY = TPY[i] - MPY[i];
+		const float RZ = TPZ[i] - MPZ[i];
+		const float VRX = TVX[i] - MVX[i];
+		const float VRY = TVY[i] - MVY[i];
+		const float VRZ = TVZ[i] - MVZ[i];
+
+		// Line-of-sight rotation rate: (R x Vr) / |R|^2
+		const float InvRangeSq = 1.0f / FMath::Max(RX * RX + RY * RY + RZ * RZ, 1.0f);
+		const float WX = (RY * VRZ - RZ * VRY) * InvRangeSq;
+		const float WY = (RZ * VRX - RX * VRZ) * InvRangeSq;
+		const float WZ = (RX * VRY - RY * VRX) * InvRangeSq;
+
+		// Commanded acceleration: N * (W x Vm), perpendicular to the missile velocity
+		const float AX = NavigationConstant * (WY * MVZ[i] - WZ * MVY[i]);
+		const float AY = NavigationConstant * (WZ * MVX[i] - WX * MVZ[i]);
+		const float AZ = NavigationConstant * (WX * MVY[i] - WY * MVX[i]);
+
+		// Limit the turn rate (acceleration / speed) to the missile's handling
+		const float Speed = FMath::Sqrt(FMath::Max(MVX[i] * MVX[i] + MVY[i] * MVY[i] + MVZ[i] * MVZ[i], KINDA_SMALL_NUMBER));
+		const float Accel = FMath::Sqrt(AX * AX + AY * AY + AZ * AZ);
+		const float AccelScale = FMath::Min(1.0f, MaxTurnRate * Speed / FMath::Max(Accel, KINDA_SMALL_NUMBER));
+
+		// Rotate the flight direction by the turn over this step
+		const float TurnScale = AccelScale * DeltaTime / Speed;
+		const float NX = MVX[i] / Speed + AX * TurnScale;
+		const float NY = MVY[i] / Speed + AY * TurnScale;
+		const float NZ = MVZ[i] / Speed + AZ * TurnScale;
+		const float InvLength = 1.0f / FMath::Sqrt(FMath::Max(NX * NX + NY * NY + NZ * NZ, KINDA_SMALL_NUMBER));
+
+		DX[i] = NX * InvLength;
+		DY[i] = NY * InvLength;
+		DZ[i] = NZ * InvLength;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UTGMMissileGuidanceSubsystem
+
+void UTGMMissileGuidanceSubsystem::RegisterMissile(ATGMMissileAIController* MissileController)
+{
+	Missiles.AddUnique(MissileController);
+}
+
+void UTGMMissileGuidanceSubsystem::UnregisterMissile(ATGMMissileAIController* MissileController)
+{
+	Missiles.RemoveSwap(MissileController);
+}
+
+bool UTGMMissileGuidanceSubsystem::IsTickable() const
+{
+	return !IsTemplate() && Missiles.Num() > 0;
+}
+
+TStatId UTGMMissileGuidanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UTGMMissileGuidanceSubsystem, STATGROUP_Tickables);
+}
+
+void UTGMMissileGuidanceSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMMissileGuidance);
+
+	Missiles.RemoveAllSwap([](const TWeakObjectPtr<ATGMMissileAIController>& MissileController)
+	{
+		return !MissileController.IsValid();
+	});
+
+	// Gather missiles that have something to steer towards. Guided ones are moved to the front so scatter can walk them in order.
+	Batch.SetNum(Missiles.Num());
+	int32 NumGuided = 0;
+
+	for (int32 i = 0; i < Missiles.Num(); i++)
+	{
+		ATGMMissileAIController* MissileController = Missiles[i].Get();
+		const APawn* Missile = MissileController->GetPawn();
+		const AActor* Target = MissileController->GetTarget();
+
+		if (Missile == nullptr || Target == nullptr)
+		{
+			continue;
+		}
+
+		const FVector MissileLocation = Missile->GetActorLocation();
+		const FVector MissileVelocity = Missile->GetVelocity();
+		const FVector TargetLocation = Target->GetActorLocation();
+		const FVector TargetVelocity = Target->GetVelocity();
+
+		Batch.MissilePosX[NumGuided] = MissileLocation.X;
+		Batch.MissilePosY[NumGuided] = MissileLocation.Y;
+		Batch.MissilePosZ[NumGuided] = MissileLocation.Z;
+		Batch.MissileVelX[NumGuided] = MissileVelocity.X;
+		Batch.MissileVelY[NumGuided] = MissileVelocity.Y;
+		Batch.MissileVelZ[NumGuided] = MissileVelocity.Z;
+		Batch.TargetPosX[NumGuided] = TargetLocation.X;
+		Batch.TargetPosY[NumGuided] = TargetLocation.Y;
+		Batch.TargetPosZ[NumGuided] = TargetLocation.Z;
+		Batch.TargetVelX[NumGuided] = TargetVelocity.X;
+		Batch.TargetVelY[NumGuided] = TargetVelocity.Y;
+		Batch.TargetVelZ[NumGuided] = TargetVelocity.Z;
+
+		Missiles.Swap(i, NumGuided);
+		NumGuided++;
+	}
+
+	Batch.SetNum(NumGuided);
+	TGMMissileGuidance::ComputeProportionalNavigation(Batch, NavigationConstant, FMath::DegreesToRadians(MaxTurnRate), DeltaTime);
+
+	// The projectile flies along its control rotation on its next tick
+	for (int32 i = 0; i < NumGuided; i++)
+	{
+		Missiles[i]->SetControlRotation(FVector(Batch.DirX[i], Batch.DirY[i], Batch.DirZ[i]).Rotation());
+	}
+
+	INC_DWORD_STAT_BY(STAT_TGMMissilesGuided, NumGuided);
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+// Time the subsystem's full tick: resolving controllers, reading pawn and target transforms, guidance, and writing
+// control rotations. Stand-in pawns are spawned in a throwaway world, so no level needs to be loaded.
+static double BenchMissileGuidanceTick(int32 NumMissiles, int32 NumFrames, float DeltaTime)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("TGMBenchMissileGuidance"), nullptr, true, ERHIFeatureLevel::Num,
+		&UWorld::InitializationValues().InitializeScenes(false).AllowAudioPlayback(false));
+	FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+	WorldContext.SetCurrentWorld(World);
+
+	FRandomStream Random(1337);
+	for (int32 i = 0; i < NumMissiles; i++)
+	{
+		const FVector TargetLocation = Random.GetUnitVector() * 1000.0f;
+		const FVector MissileLocation = TargetLocation + Random.GetUnitVector() * Random.FRandRange(3000.0f, 6000.0f);
+
+		APawn* Target = World->SpawnActor<ADefaultPawn>(TargetLocation, FRotator::ZeroRotator);
+		APawn* Missile = World->SpawnActor<ADefaultPawn>(MissileLocation, (TargetLocation - MissileLocation).Rotation());
+		ATGMMissileAIController* MissileController = World->SpawnActor<ATGMMissileAIController>();
+
+		// Possessing registers the controller with the world's guidance subsystem
+		MissileController->SetTarget(Target);
+		MissileController->Possess(Missile);
+	}
+
+	UTGMMissileGuidanceSubsystem* Guidance = World->GetSubsystem<UTGMMissileGuidanceSubsystem>();
+	double TickTime = 0.0;
+
+	if (Guidance != nullptr)
+	{
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Frame = 0; Frame < NumFrames; Frame++)
+		{
+			Guidance->Tick(DeltaTime);
+		}
+		TickTime = FPlatformTime::Seconds() - Start;
+	}
+
+	GEngine->DestroyWorldContext(World);
+	World->DestroyWorld(false);
+	World->RemoveFromRoot();
+
+	return TickTime / NumFrames;
+}
+
+static void BenchMissileGuidance(const TArray<FString>& Args)
+{
+	const int32 NumMissiles = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 1000;
+
+	if (NumMissiles <= 0)
+	{
+		UE_LOG(LogTGMGuidance, Warning, TEXT("Usage: TGM.BenchMissileGuidance [NumMissiles]"));
+		return;
+	}
+
+	// Match the projectile and character defaults: 1500 cm/s missiles with a 7 second lifespan, weaving targets at running speed
+	const float DeltaTime = 1.0f / 60.0f;
+	const int32 NumSteps = FMath::CeilToInt(7.0f / DeltaTime);
+	const float MissileSpeed = 1500.0f;
+	const float TargetSpeed = 600.0f;
+	const float HitDistance = 15.0f + 55.0f;
+	const UTGMMissileGuidanceSubsystem* Defaults = GetDefault<UTGMMissileGuidanceSubsystem>();
+
+	FRandomStream Random(1337);
+	FTGMGuidanceBatch Batch;
+	Batch.SetNum(NumMissiles);
+
+	TArray<FVector> TargetHeadings;
+	TArray<float> WeavePhases;
+	TArray<float> ClosestDistances;
+	TArray<float> InterceptTimes;
+	TargetHeadings.SetNum(NumMissiles);
+	WeavePhases.SetNum(NumMissiles);
+	ClosestDistances.Init(MAX_flt, NumMissiles);
+	InterceptTimes.Init(-1.0f, NumMissiles);
+
+	// Missiles start 3000 to 6000 cm away, launched up to 30 degrees off the line of sight
+	for (int32 i = 0; i < NumMissiles; i++)
+	{
+		const FVector Target = Random.GetUnitVector() * 1000.0f;
+		const FVector Missile = Target + Random.GetUnitVector() * Random.FRandRange(3000.0f, 6000.0f);
+		const FVector Launch = Random.VRandCone((Target - Missile).GetSafeNormal(), FMath::DegreesToRadians(30.0f)) * MissileSpeed;
+
+		Batch.MissilePosX[i] = Missile.X;
+		Batch.MissilePosY[i] = Missile.Y;
+		Batch.MissilePosZ[i] = Missile.Z;
+		Batch.MissileVelX[i] = Launch.X;
+		Batch.MissileVelY[i] = Launch.Y;
+		Batch.MissileVelZ[i] = Launch.Z;
+		Batch.TargetPosX[i] = Target.X;
+		Batch.TargetPosY[i] = Target.Y;
+		Batch.TargetPosZ[i] = Target.Z;
+
+		TargetHeadings[i] = FVector(Random.GetUnitVector().GetSafeNormal2D());
+		WeavePhases[i] = Random.FRandRange(0.0f, 2.0f * PI);
+	}
+
+	double GuidanceTime = 0.0;
+
+	for (int32 Step = 0; Step < NumSteps; Step++)
+	{
+		const float Time = Step * DeltaTime;
+
+		// Targets run along their heading and weave sideways
+		for (int32 i = 0; i < NumMissiles; i++)
+		{
+			const FVector Side(-TargetHeadings[i].Y, TargetHeadings[i].X, 0.0f);
+			const FVector TargetVelocity = TargetHeadings[i] * TargetSpeed + Side * (TargetSpeed * FMath::Sin(2.0f * Time + WeavePhases[i]));
+
+			Batch.TargetVelX[i] = TargetVelocity.X;
+			Batch.TargetVelY[i] = TargetVelocity.Y;
+			Batch.TargetVelZ[i] = TargetVelocity.Z;
+		}
+
+		const double StepStart = FPlatformTime::Seconds();
+		TGMMissileGuidance::ComputeProportionalNavigation(Batch, Defaults->NavigationConstant, FMath::DegreesToRadians(Defaults->MaxTurnRate), DeltaTime);
+		GuidanceTime += FPlatformTime::Seconds() - StepStart;
+
+		// Integrate the way the projectile does: constant speed along the guided direction
+		for (int32 i = 0; i < NumMissiles; i++)
+		{
+			Batch.MissileVelX[i] = Batch.DirX[i] * MissileSpeed;
+			Batch.MissileVelY[i] = Batch.DirY[i] * MissileSpeed;
+			Batch.MissileVelZ[i] = Batch.DirZ[i] * MissileSpeed;
+			Batch.MissilePosX[i] += Batch.MissileVelX[i] * DeltaTime;
+			Batch.MissilePosY[i] += Batch.MissileVelY[i] * DeltaTime;
+			Batch.MissilePosZ[i] += Batch.MissileVelZ[i] * DeltaTime;
+			Batch.TargetPosX[i] += Batch.TargetVelX[i] * DeltaTime;
+			Batch.TargetPosY[i] += Batch.TargetVelY[i] * DeltaTime;
+			Batch.TargetPosZ[i] += Batch.TargetVelZ[i] * DeltaTime;
+
+			const float Distance = FVector::Dist(FVector(Batch.MissilePosX[i], Batch.MissilePosY[i], Batch.MissilePosZ[i]), FVector(Batch.TargetPosX[i], Batch.TargetPosY[i], Batch.TargetPosZ[i]));
+			if (InterceptTimes[i] < 0.0f)
+			{
+				ClosestDistances[i] = FMath::Min(ClosestDistances[i], Distance);
+				if (Distance <= HitDistance)
+				{
+					InterceptTimes[i] = Time + DeltaTime;
+				}
+			}
+		}
+	}
+
+	int32 NumIntercepts = 0;
+	double TotalInterceptTime = 0.0;
+	double TotalMissDistance = 0.0;
+
+	for (int32 i = 0; i < NumMissiles; i++)
+	{
+		if (InterceptTimes[i] >= 0.0f)
+		{
+			NumIntercepts++;
+			TotalInterceptTime += InterceptTimes[i];
+		}
+		else
+		{
+			TotalMissDistance += ClosestDistances[i];
+		}
+	}
+
+	const int32 NumMisses = NumMissiles - NumIntercepts;
+	const double MicrosecondsPerStep = GuidanceTime * 1e6 / NumSteps;
+
+	UE_LOG(LogTGMGuidance, Display, TEXT("Missile guidance: %d missiles, %.1f%% intercepted (avg %.2fs), misses passed %.0fcm away on avg"),
+		NumMissiles, 100.0 * NumIntercepts / NumMissiles, NumIntercepts > 0 ? TotalInterceptTime / NumIntercepts : 0.0, NumMisses > 0 ? TotalMissDistance / NumMisses : 0.0);
+	UE_LOG(LogTGMGuidance, Display, TEXT("Missile guidance: %.2f us per batch step, %.2f us per 1000 missiles (guidance math only)"),
+		MicrosecondsPerStep, MicrosecondsPerStep * 1000.0 / NumMissiles);
+
+	// The subsystem tick also gathers from and scatters to the actors, which usually costs more than the math
+	const double MicrosecondsPerTick = BenchMissileGuidanceTick(NumMissiles, 100, DeltaTime) * 1e6;
+
+	UE_LOG(LogTGMGuidance, Display, TEXT("Missile guidance: %.2f us per subsystem tick, %.2f us per 1000 missiles (gather, guidance and scatter)"),
+		MicrosecondsPerTick, MicrosecondsPerTick * 1000.0 / NumMissiles);
+}
+
+static FAutoConsoleCommand BenchMissileGuidanceCommand(
+	TEXT("TGM.BenchMissileGuidance"),
+	TEXT("Runs a headless intercept scenario for AI guided missiles and measures guidance CPU cost. Usage: TGM.BenchMissileGuidance [NumMissiles=1000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchMissileGuidance));
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Tickable.h"
+#include "TGMMissileGuidance.generated.h"
+
+class ATGMMissileAIController;
+
+/**
+ * Structure-of-arrays guidance state, one entry per missile, laid out so the guidance loop can process four missiles per SIMD instruction
+ */
+struct TGM_API FTGMGuidanceBatch
+{
+	// Missile position and velocity
+	TArray<float> MissilePosX, MissilePosY, MissilePosZ;
+	TArray<float> MissileVelX, MissileVelY, MissileVelZ;
+
+	// Target position and velocity
+	TArray<float> TargetPosX, TargetPosY, TargetPosZ;
+	TArray<float> TargetVelX, TargetVelY, TargetVelZ;
+
+	// Output flight direction, normalized
+	TArray<float> DirX, DirY, DirZ;
+
+	void SetNum(int32 NewNum);
+
+	int32 Num() const { return MissilePosX.Num(); }
+};
+
+namespace TGMMissileGuidance
+{
+	/**
+	 * Proportional navigation for a whole batch: turns each missile with an acceleration of
+	 * NavigationConstant times the line-of-sight rotation rate crossed with the missile velocity.
+	 * @param MaxTurnRate	Maximum turn rate, in rad/s
+	 * @param DeltaTime		Time step the new directions are computed for
+	 */
+	TGM_API void ComputeProportionalNavigation(FTGMGuidanceBatch& Batch, float NavigationConstant, float MaxTurnRate, float DeltaTime);
+}
+
+/**
+ * Steers every AI guided projectile in one batch per frame instead of a per-missile behavior tick
+ */
+UCLASS(config=Game)
+class TGM_API UTGMMissileGuidanceSubsystem : public UWorldSubsystem, public FTickableGameObject
+{
+	GENERATED_BODY()
+
+public:
+	// FTickableGameObject interface
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual TStatId GetStatId() const override;
+	// End of FTickableGameObject interface
+
+	void RegisterMissile(ATGMMissileAIController* MissileController);
+
+	void UnregisterMissile(ATGMMissileAIController* MissileController);
+
+	/** Proportional navigation constant, typically between 3 and 5 */
+	UPROPERTY(Config, EditAnywhere, Category = Guidance)
+	float NavigationConstant = 4.0f;
+
+	/** Maximum AI missile turn rate, in deg/sec */
+	UPROPERTY(Config, EditAnywhere, Category = Guidance)
+	float MaxTurnRate = 120.0f;
+
+private:
+	TArray<TWeakObjectPtr<ATGMMissileAIController>> Missiles;
+
+	// Guidance inputs and outputs of the missiles at the front of Missiles, index for index
+	FTGMGuidanceBatch Batch;
+};
@@ -7,6 +7,47 @@
 #include "Components/SphereComponent.h"
 #include "Components/AudioComponent.h"
 #include "TGMCharacter.h"
+#include "TGMSteeringInput.h"
+#include "TGMImpulseGovernor.h"
+#include "TGMExplosionDamage.h"
+#include "TGM.h"
+#include "Framework/Application/SlateApplication.h"
+#include "GameFramework/InputSettings.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerInput.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/LocalPlayer.h"
+#include "Engine/GameViewportClient.h"
+#include "Widgets/SViewport.h"
+#include "GameFramework/GameStateBase.h"
+#include "Engine/GameInstance.h"
+
+DECLARE_CYCLE_STAT(TEXT("Integrate Steering Input"), STAT_TGMIntegrateSteering, STATGROUP_TGM);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Steering Samples Integrated"), STAT_TGMSteeringSamplesIntegrated, STATGROUP_TGM);
+// Time from Slate receiving a mouse event to the projectile velocity using it. OS, driver and message pump delays before Slate
+// and rendering after the velocity update are outside the engine's view and not included.
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Steering Sample Age Avg (ms)"), STAT_TGMSteeringSampleAgeAvg, STATGROUP_TGM);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Steering Sample Age Max (ms)"), STAT_TGMSteeringSampleAgeMax, STATGROUP_TGM);
+
+namespace
+{
+	// Returns the scale of the mapping that binds Key to AxisName, or 0 if there is none
+	float GetAxisMappingScale(FName AxisName, const FKey& Key)
+	{
+		TArray<FInputAxisKeyMapping> Mappings;
+		UInputSettings::GetInputSettings()->GetAxisMappingByName(AxisName, Mappings);
+
+		for (const FInputAxisKeyMapping& Mapping : Mappings)
+		{
+			if (Mapping.Key == Key)
+			{
+				return Mapping.Scale;
+			}
+		}
+
+		return 0.0f;
+	}
+}
 
 // Sets default values
 ATGMProjectile::ATGMProjectile()
@@ -22,10 +63,26 @@ ATGMProjectile::ATGMProjectile()
 	BoostSpeedMultiplier = 2.0f;
 	bIsBoosted = false;
 
+	// Sample mouse steering per input event rather than once per frame
+	bUseSubFrameSteering = true;
+	LastSteeringTime = 0.0;
+
+	// Shot telemetry is only recorded once fired
+	FMemory::Memzero(ShotRecord);
+	FireWorldTime = -1.0f;
+	LastLocation = FVector::ZeroVector;
+	ShotId = 0;
+
 	// Explosion related values
 	ImpulseRadius = 300.0f;
 	ImpulseMagnitude = 500000.0f;
 
+	// Explosion damage falls off linearly over the impulse radius
+	ExplosionDamage = 100.0f;
+	MinimumExplosionDamage = 10.0f;
+	ExplosionInnerRadius = 50.0f;
+	ExplosionDamageFalloff = 1.0f;
+
  	// Set this actor to call Tick() every frame
 	PrimaryActorTick.bCanEverTick = true;
 
@@ -100,13 +157,17 @@ void ATGMProjectile::SetupPlayerInputComponent(class UInputComponent* PlayerInpu
 	// We have 2 versions of the rotation bindings to handle different kinds of devices differently
 	// "turn" handles devices that provide an absolute delta, such as a mouse.
 	// "turnrate" is for devices that we choose to treat as a rate of change, such as an analog joystick
-	PlayerInputComponent->BindAxis("Turn", this, &APawn::AddControllerYawInput);
+	// Absolute mouse deltas are captured by the steering sample buffer when it is available
+	if (!CanUseSubFrameSteering())
+	{
+		PlayerInputComponent->BindAxis("Turn", this, &APawn::AddControllerYawInput);
+		PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
+	}
 	PlayerInputComponent->BindAxis("TurnRate", this, &ATGMProjectile::TurnAtRate);
-	PlayerInputComponent->BindAxis("LookUp", this, &APawn::AddControllerPitchInput);
 	PlayerInputComponent->BindAxis("LookUpRate", this, &ATGMProjectile::LookUpAtRate);
 
 	// Custom projectile input controls
-	PlayerInputComponent->BindAction("Explode", IE_Pressed, this, &ATGMProjectile::Explode);
+	PlayerInputComponent->BindAction("Explode", IE_Pressed, this, &ATGMProjectile::ExplodeOnInput);
 	PlayerInputComponent->BindAction("Boost", IE_Pressed, this, &ATGMProjectile::Boost);
 }
 
@@ -122,15 +183,166 @@ void ATGMProjectile::BeginPlay()
 
 	// Set a timer to explode the projectile after its lifespan is over
 	FTimerHandle TimerHandle;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle, this, &ATGMProjectile::Explode, ProjectileLifeSpan, false);
+	GetWorld()->GetTimerManager().SetTimer(TimerHandle, this, &ATGMProjectile::ExplodeOnLifeSpan, ProjectileLifeSpan, false);
+}
+
+void ATGMProjectile::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	StopSteeringInput();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void ATGMProjectile::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	APlayerController* PC = Cast<APlayerController>(NewController);
+	if (CanUseSubFrameSteering() && PC != nullptr && PC->IsLocalController() && PC->PlayerInput != nullptr)
+	{
+		// Bake mouse sensitivity, inversion and axis mapping scale into the samples so they match the "Turn"/"LookUp" axis values
+		UPlayerInput* PlayerInput = PC->PlayerInput;
+		const float YawScale = PlayerInput->GetMouseSensitivityX() * GetAxisMappingScale(TEXT("Turn"), EKeys::MouseX)
+			* (PlayerInput->GetInvertAxisKey(EKeys::MouseX) ? -1.0f : 1.0f) * (PlayerInput->GetInvertAxis(TEXT("Turn")) ? -1.0f : 1.0f);
+		const float PitchScale = PlayerInput->GetMouseSensitivityY() * GetAxisMappingScale(TEXT("LookUp"), EKeys::MouseY)
+			* (PlayerInput->GetInvertAxisKey(EKeys::MouseY) ? -1.0f : 1.0f) * (PlayerInput->GetInvertAxis(TEXT("LookUp")) ? -1.0f : 1.0f);
+
+		// Only sample the mouse while this player's game viewport has captured it
+		ULocalPlayer* LocalPlayer = PC->GetLocalPlayer();
+		TSharedPtr<SViewport> GameViewport = (LocalPlayer != nullptr && LocalPlayer->ViewportClient != nullptr) ? LocalPlayer->ViewportClient->GetGameViewportWidget() : nullptr;
+
+		SteeringInput = MakeShared<FTGMSteeringInputProcessor>(YawScale, PitchScale, GameViewport);
+		FSlateApplication::Get().RegisterInputPreProcessor(SteeringInput);
+		LastSteeringTime = FPlatformTime::Seconds();
+	}
+}
+
+void ATGMProjectile::UnPossessed()
+{
+	StopSteeringInput();
+
+	Super::UnPossessed();
+}
+
+bool ATGMProjectile::CanUseSubFrameSteering() const
+{
+	return bUseSubFrameSteering && FSlateApplication::IsInitialized();
+}
+
+void ATGMProjectile::StopSteeringInput()
+{
+	if (SteeringInput.IsValid())
+	{
+		if (FSlateApplication::IsInitialized())
+		{
+			FSlateApplication::Get().UnregisterInputPreProcessor(SteeringInput);
+		}
+		SteeringInput.Reset();
+	}
+}
+
+bool ATGMProjectile::ConsumeSteeringInput(FVector& OutFlightDirection)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMIntegrateSteering);
+
+	APlayerController* PC = Cast<APlayerController>(Controller);
+	if (!SteeringInput.IsValid() || PC == nullptr)
+	{
+		return false;
+	}
+
+	FRotator Rotation = PC->GetControlRotation();
+	const bool bApplyInput = !PC->IsLookInputIgnored();
+	float YawScale = TurnRateMultiplier * PC->InputYawScale;
+	float PitchScale = LookUpRateMultiplier * PC->InputPitchScale;
+
+	// Match UPlayerInput's FOV scaling of mouse axes. Its mouse smoothing is deliberately not applied: it averages
+	// deltas over past frames, which is the lag per-event sampling removes.
+	const UInputSettings* InputSettings = UInputSettings::GetInputSettings();
+	if (InputSettings->bEnableFOVScaling && PC->PlayerCameraManager != nullptr)
+	{
+		const float FOVScale = PC->PlayerCameraManager->GetFOVAngle() * InputSettings->FOVScale;
+		YawScale *= FOVScale;
+		PitchScale *= FOVScale;
+	}
+
+	// Samples are integrated over the wall time since the last call, so each one turns the flight path from its own timestamp
+	const double IntervalStart = LastSteeringTime;
+	const double Now = FPlatformTime::Seconds();
+	LastSteeringTime = Now;
+
+	FVector Displacement = FVector::ZeroVector;
+	double SegmentStart = IntervalStart;
+	int32 NumSamples = 0;
+	double TotalAge = 0.0;
+	double MaxAge = 0.0;
+
+	// Apply every sample in arrival order, so no mouse event is lost or merged before the velocity update below
+	FTGMSteeringSample Sample;
+	while (SteeringInput->Dequeue(Sample))
+	{
+		// Fly along the heading before this sample until the sample's timestamp
+		const double SampleTime = FMath::Clamp(Sample.Timestamp, SegmentStart, Now);
+		Displacement += Rotation.Vector() * float(SampleTime - SegmentStart);
+		SegmentStart = SampleTime;
+
+		if (bApplyInput)
+		{
+			Rotation.Yaw += Sample.Yaw * YawScale;
+			Rotation.Pitch += Sample.Pitch * PitchScale;
+
+			if (PC->PlayerCameraManager != nullptr)
+			{
+				Rotation.Pitch = FMath::ClampAngle(Rotation.Pitch, PC->PlayerCameraManager->ViewPitchMin, PC->PlayerCameraManager->ViewPitchMax);
+			}
+		}
+
+		const double Age = Now - Sample.Timestamp;
+		TotalAge += Age;
+		MaxAge = FMath::Max(MaxAge, Age);
+		NumSamples++;
+	}
+
+	if (NumSamples == 0)
+	{
+		return false;
+	}
+
+	// The newest heading holds from the last sample to now
+	Displacement += Rotation.Vector() * float(Now - SegmentStart);
+
+	const float Interval = float(Now - IntervalStart);
+	OutFlightDirection = (Interval > KINDA_SMALL_NUMBER) ? Displacement / Interval : Rotation.Vector();
+
+	PC->SetControlRotation(Rotation);
+
+	INC_DWORD_STAT_BY(STAT_TGMSteeringSamplesIntegrated, NumSamples);
+	SET_FLOAT_STAT(STAT_TGMSteeringSampleAgeAvg, TotalAge * 1000.0 / NumSamples);
+	SET_FLOAT_STAT(STAT_TGMSteeringSampleAgeMax, MaxAge * 1000.0);
+
+	return true;
 }
 
 void ATGMProjectile::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
 
-	// Set the movement component velocity manually every frame so that it follows the rotation
-	ProjectileMovementComponent->Velocity = Controller->GetControlRotation().Vector() * ProjectileMovementComponent->MaxSpeed;
+	// Set the movement component velocity manually every frame so that it follows the rotation.
+	// With buffered mouse steering, it follows the rotation as it changed over the frame instead of only its final value.
+	FVector FlightDirection;
+	if (!ConsumeSteeringInput(FlightDirection))
+	{
+		FlightDirection = Controller->GetControlRotation().Vector();
+	}
+	ProjectileMovementComponent->Velocity = FlightDirection * ProjectileMovementComponent->MaxSpeed;
+
+	// Accumulate the flight path length for telemetry
+	if (FireWorldTime >= 0.0f)
+	{
+		const FVector Location = GetActorLocation();
+		ShotRecord.DistanceFlown += FVector::Dist(Location, LastLocation);
+		LastLocation = Location;
+	}
 
 	// Interpolate camera post-process settings until finished
 	if (CameraLerpTimeLeft > 0.0f)
@@ -174,14 +386,38 @@ void ATGMProjectile::FireInDirection(const FVector& ShootDirection, ATGMCharacte
 	ProjectileCamera->SetActive(true);
 	PawnOwner = pawnOwner;
 	CollisionComponent->IgnoreActorWhenMoving(PawnOwner, true);
+
+	// Start the shot telemetry with the tuning the projectile is fired with
+	FireWorldTime = GetWorld()->GetTimeSeconds();
+	LastLocation = GetActorLocation();
+	ShotRecord.FireTime = (FDateTime::UtcNow() - FDateTime(1970, 1, 1)).GetTotalSeconds();
+	ShotRecord.BoostTime = -1.0f;
+	ShotRecord.TurnRateMultiplier = TurnRateMultiplier;
+	ShotRecord.BoostSpeedMultiplier = BoostSpeedMultiplier;
+	ShotRecord.ProjectileLifeSpan = ProjectileLifeSpan;
+}
+
+float ATGMProjectile::GetMaxFlightDistance() const
+{
+	return ProjectileMovementComponent->MaxSpeed * FMath::Max(1.0f, BoostSpeedMultiplier) * ProjectileLifeSpan;
 }
 
 void ATGMProjectile::OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& Hit)
 {
-	Explode();
+	Explode(ETGMExplodeCause::Hit);
 }
 
-void ATGMProjectile::Explode()
+void ATGMProjectile::ExplodeOnInput()
+{
+	Explode(ETGMExplodeCause::Manual);
+}
+
+void ATGMProjectile::ExplodeOnLifeSpan()
+{
+	Explode(ETGMExplodeCause::LifeSpan);
+}
+
+void ATGMProjectile::Explode(ETGMExplodeCause Cause)
 {
 	// Spawn and activate explosion VFX
 	UParticleSystemComponent* PSC = UGameplayStatics::SpawnEmitterAtLocation(this, ExplosionFX, GetActorLocation(), GetActorRotation(), true);
@@ -192,8 +428,27 @@ void ATGMProjectile::Explode()
 	// Simulate projectile shockwave
 	ApplyRadialImpulse();
 
-	// Let the controller possess the original character
-	if (Controller != nullptr)
+	// Damage everything caught in the explosion
+	ApplyExplosionDamage();
+
+	// Let the server confirm any characters hit
+	ReportHitsToServer();
+
+	// Record the finished shot. Only player steered shots are recorded: AI missiles ignore the handling tuning and never boost.
+	UTGMShotTelemetrySubsystem* ShotTelemetry = GetGameInstance() ? GetGameInstance()->GetSubsystem<UTGMShotTelemetrySubsystem>() : nullptr;
+	const bool bIsPlayerShot = Controller != nullptr && Controller->IsPlayerController();
+	if (ShotTelemetry != nullptr && bIsPlayerShot && FireWorldTime >= 0.0f)
+	{
+		// Include the distance moved since the last tick, e.g. up to the point of impact
+		ShotRecord.DistanceFlown += FVector::Dist(GetActorLocation(), LastLocation);
+		ShotRecord.FlightDuration = GetWorld()->GetTimeSeconds() - FireWorldTime;
+		ShotRecord.ExplodeCause = uint8(Cause);
+		ShotTelemetry->RecordShot(ShotRecord);
+		FireWorldTime = -1.0f;
+	}
+
+	// Let the player controller possess the original character. AI controllers go away with the projectile.
+	if (Controller != nullptr && Controller->IsPlayerController())
 	{
 		PawnOwner->SetActorRotation(PawnOwner->GetOldRotation());
 		Controller->Possess(PawnOwner);
@@ -216,6 +471,10 @@ void ATGMProjectile::ApplyRadialImpulse()
 	FVector ActorLocation = GetActorLocation();
 	TArray<UPrimitiveComponent*> OutComponents;
 	UKismetSystemLibrary::SphereOverlapComponents(this, ActorLocation, ImpulseRadius, ObjectTypes, nullptr, ActorsToIgnore, OutComponents);
+	ShotRecord.NumComponentsHit = FMath::Min(OutComponents.Num(), int32(MAX_uint16));
+
+	// Impulses go through the governor so explosion bursts don't wake every body at once
+	UTGMImpulseGovernor* ImpulseGovernor = GetWorld()->GetSubsystem<UTGMImpulseGovernor>();
 
 	FVector Impulse;
 	UPrimitiveComponent* Component;
@@ -225,7 +484,72 @@ void ATGMProjectile::ApplyRadialImpulse()
 
 		// Add impulse from explosion center to component location
 		Impulse = (Component->GetComponentLocation() - ActorLocation).GetSafeNormal() * ImpulseMagnitude;
-		OutComponents[i]->AddImpulse(Impulse);
+
+		if (ImpulseGovernor != nullptr)
+		{
+			ImpulseGovernor->QueueImpulse(Component, Impulse);
+		}
+		else
+		{
+			Component->AddImpulse(Impulse);
+		}
+	}
+}
+
+void ATGMProjectile::ApplyExplosionDamage()
+{
+	// Damage is only dealt by the server, clients report hits instead
+	UTGMExplosionDamageSubsystem* ExplosionDamageSubsystem = GetWorld()->GetSubsystem<UTGMExplosionDamageSubsystem>();
+	if (GetNetMode() == NM_Client || ExplosionDamageSubsystem == nullptr)
+	{
+		return;
+	}
+
+	ExplosionDamageSubsystem->QueueExplosion(MakeExplosion(GetActorLocation(), PawnOwner));
+}
+
+FTGMExplosion ATGMProjectile::MakeExplosion(const FVector& Location, AActor* ExplosionInstigator) const
+{
+	FTGMExplosion Explosion;
+	Explosion.Location = Location;
+	Explosion.Radius = ImpulseRadius;
+	Explosion.InnerRadius = ExplosionInnerRadius;
+	Explosion.BaseDamage = ExplosionDamage;
+	Explosion.MinimumDamage = MinimumExplosionDamage;
+	Explosion.DamageFalloff = ExplosionDamageFalloff;
+	Explosion.Instigator = ExplosionInstigator;
+
+	return Explosion;
+}
+
+void ATGMProjectile::ReportHitsToServer()
+{
+	AGameStateBase* GameState = GetWorld()->GetGameState();
+	if (GetNetMode() != NM_Client || PawnOwner == nullptr || GameState == nullptr)
+	{
+		return;
+	}
+
+	TArray<TEnumAsByte<EObjectTypeQuery>> ObjectTypes;
+	ObjectTypes.Add(UEngineTypes::ConvertToObjectType(ECollisionChannel::ECC_Pawn));
+
+	TArray<AActor*> ActorsToIgnore;
+	ActorsToIgnore.Add(this);
+	ActorsToIgnore.Add(PawnOwner);
+
+	// Get all characters within ImpulseRadius from explosion center
+	TArray<AActor*> OutActors;
+	UKismetSystemLibrary::SphereOverlapActors(this, GetActorLocation(), ImpulseRadius, ObjectTypes, ATGMCharacter::StaticClass(), ActorsToIgnore, OutActors);
+
+	for (AActor* Actor : OutActors)
+	{
+		FTGMHitClaim Claim;
+		Claim.Target = Cast<ATGMCharacter>(Actor);
+		Claim.ImpactLocation = GetActorLocation();
+		Claim.Timestamp = GameState->GetServerWorldTimeSeconds();
+		Claim.ShotId = ShotId;
+
+		PawnOwner->ServerReportHit(Claim);
 	}
 }
 
@@ -236,6 +560,11 @@ void ATGMProjectile::Boost()
 	{
 		bIsBoosted = true;
 
+		if (FireWorldTime >= 0.0f)
+		{
+			ShotRecord.BoostTime = GetWorld()->GetTimeSeconds() - FireWorldTime;
+		}
+
 		// Limit handling even more
 		LookUpRateMultiplier *= BoostHandlingMultiplier;
 		TurnRateMultiplier *= BoostHandlingMultiplier;
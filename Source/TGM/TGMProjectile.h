@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "TGMShotTelemetry.h"
 #include "TGMProjectile.generated.h"
 
 /**
@@ -37,6 +38,12 @@ public:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void PossessedBy(AController* NewController) override;
+
+	virtual void UnPossessed() override;
+
 	// Sphere collision component
 	UPROPERTY(VisibleDefaultsOnly, Category = Projectile)
 	class USphereComponent* CollisionComponent;
@@ -61,6 +68,27 @@ public:
 	// Function that initializes the projectile's velocity in the shoot direction.
 	void FireInDirection(const FVector& ShootDirection, class ATGMCharacter* pawnOwner);
 
+	// Returns the character that fired this projectile
+	class ATGMCharacter* GetPawnOwner() const { return PawnOwner; }
+
+	// Returns the projectile follow camera
+	class UCameraComponent* GetProjectileCamera() const { return ProjectileCamera; }
+
+	// Returns the radius of the explosion shockwave
+	float GetImpulseRadius() const { return ImpulseRadius; }
+
+	// Returns the time after which the projectile self-destructs
+	float GetProjectileLifeSpan() const { return ProjectileLifeSpan; }
+
+	// Sets the id hit claims for this shot are reported with
+	void SetShotId(uint16 InShotId) { ShotId = InShotId; }
+
+	// Returns the damage this projectile's explosion deals at the given location
+	struct FTGMExplosion MakeExplosion(const FVector& Location, AActor* ExplosionInstigator) const;
+
+	// Returns the farthest the projectile can fly from where it was fired, boosted for its whole lifespan
+	float GetMaxFlightDistance() const;
+
 protected:
 	
 	// Follow camera
@@ -109,6 +137,22 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Projectile)
 	float ImpulseMagnitude;
 
+	// Explosion damage within ExplosionInnerRadius
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float ExplosionDamage;
+
+	// Explosion damage at ImpulseRadius
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float MinimumExplosionDamage;
+
+	// Radius within which full explosion damage is dealt
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float ExplosionInnerRadius;
+
+	// Exponent of the damage falloff towards ImpulseRadius, 1 is linear
+	UPROPERTY(EditDefaultsOnly, Category = Damage)
+	float ExplosionDamageFalloff;
+
 	UPROPERTY(EditDefaultsOnly, Category = Projectile)
 	float MaxCameraLerpTime;
 
@@ -126,9 +170,31 @@ protected:
 	UPROPERTY(EditDefaultsOnly, Category = Projectile)
 	float TargetVignetteIntensity;
 
+	// Whether mouse steering is sampled per input event instead of once per frame
+	UPROPERTY(EditDefaultsOnly, Category = Handling)
+	bool bUseSubFrameSteering;
+
 	// Whether projectile has already been boosted
 	bool bIsBoosted;
 
+	// Buffered steering samples, valid while possessed by a local player with sub-frame steering
+	TSharedPtr<class FTGMSteeringInputProcessor> SteeringInput;
+
+	// Platform time up to which steering samples have been integrated
+	double LastSteeringTime;
+
+	// Telemetry of this shot, filled in during flight and recorded on explosion
+	FTGMShotRecord ShotRecord;
+
+	// World time the projectile was fired at, negative until fired
+	float FireWorldTime;
+
+	// Id of this shot, set by the character that fired it
+	uint16 ShotId;
+
+	// Location at the previous tick, used to measure the distance flown
+	FVector LastLocation;
+
 	// Called when the projectile hits something
 	UFUNCTION()
 	void OnHit(UPrimitiveComponent* HitComponent, AActor* OtherActor, UPrimitiveComponent* OtherComponent, FVector NormalImpulse, const FHitResult& Hit);
@@ -136,6 +202,22 @@ protected:
 	// Simulate explosion shockwave
 	void ApplyRadialImpulse();
 
+	// On clients, report characters caught in the explosion to the server for validation
+	void ReportHitsToServer();
+
+	// Queue explosion damage for everything with health within ImpulseRadius
+	void ApplyExplosionDamage();
+
+	// Whether steering input can be captured through the sub-frame sample buffer
+	bool CanUseSubFrameSteering() const;
+
+	// Unregister and release the steering sample buffer
+	void StopSteeringInput();
+
+	// Apply all buffered steering samples to the control rotation. Returns false if there were none, otherwise
+	// OutFlightDirection is the heading averaged over the frame, each sample taking effect at its timestamp.
+	bool ConsumeSteeringInput(FVector& OutFlightDirection);
+
 	/**
 	 * Called via input to turn at a given rate.
 	 * @param Rate	This is a normalized rate, i.e. 1.0 means 100% of desired turn rate
@@ -153,7 +235,13 @@ protected:
 	// End of APawn interface
 
 	// Explode the projectile and play all relevant FX
-	void Explode();
+	void Explode(ETGMExplodeCause Cause);
+
+	// Explode on player input
+	void ExplodeOnInput();
+
+	// Explode once the projectile's lifespan is over
+	void ExplodeOnLifeSpan();
 
 	// Boost projectile speed on player input
 	void Boost();
@@ -0,0 +1,265 @@
+#include "TGMShotTelemetry.h"
+#include "TGM.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/Compression.h"
+#include "Misc/Paths.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTGMTelemetry, Log, All);
+
+DECLARE_CYCLE_STAT(TEXT("Record Shot Telemetry"), STAT_TGMRecordShot, STATGROUP_TGM);
+DECLARE_CYCLE_STAT(TEXT("Write Shot Telemetry"), STAT_TGMWriteShots, STATGROUP_TGM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Telemetry Shots Recorded"), STAT_TGMShotsRecorded, STATGROUP_TGM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Telemetry Shots Dropped"), STAT_TGMShotsDropped, STATGROUP_TGM);
+
+FString TGMShotTelemetry::GetDefaultDirectory()
+{
+	return FPaths::ProjectSavedDir() / TEXT("Telemetry");
+}
+
+//////////////////////////////////////////////////////////////////////////
+// FTGMShotTelemetryWriter
+
+FTGMShotTelemetryWriter::FTGMShotTelemetryWriter(const FString& InDirectory, int64 InMaxFileSize, int32 InMaxFiles, float InFlushInterval)
+	: Queue(QueueCapacity)
+	, Directory(InDirectory)
+	, MaxFileSize(FMath::Max<int64>(InMaxFileSize, 1024))
+	, MaxFiles(FMath::Max(InMaxFiles, 1))
+	, FlushInterval(FMath::Max(InFlushInterval, 0.01f))
+	, Thread(nullptr)
+	, WakeEvent(FPlatformProcess::GetSynchEventFromPool())
+	, bStopping(false)
+	, BytesWritten(0)
+	, FileIndex(0)
+{
+	Batch.Reserve(QueueCapacity);
+	Thread = FRunnableThread::Create(this, TEXT("TGMShotTelemetry"), 0, TPri_BelowNormal);
+}
+
+FTGMShotTelemetryWriter::~FTGMShotTelemetryWriter()
+{
+	// The thread writes whatever is still queued before exiting
+	if (Thread != nullptr)
+	{
+		Stop();
+		Thread->WaitForCompletion();
+		delete Thread;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+}
+
+bool FTGMShotTelemetryWriter::Record(const FTGMShotRecord& ShotRecord)
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMRecordShot);
+
+	if (!Queue.Enqueue(ShotRecord))
+	{
+		INC_DWORD_STAT(STAT_TGMShotsDropped);
+		return false;
+	}
+
+	INC_DWORD_STAT(STAT_TGMShotsRecorded);
+	return true;
+}
+
+void FTGMShotTelemetryWriter::Flush()
+{
+	WakeEvent->Trigger();
+}
+
+void FTGMShotTelemetryWriter::Stop()
+{
+	bStopping = true;
+	WakeEvent->Trigger();
+}
+
+uint32 FTGMShotTelemetryWriter::Run()
+{
+	while (!bStopping)
+	{
+		WakeEvent->Wait(FTimespan::FromSeconds(FlushInterval));
+		WritePending();
+	}
+
+	// Final drain, then close the file
+	WritePending();
+	File.Reset();
+
+	return 0;
+}
+
+void FTGMShotTelemetryWriter::WritePending()
+{
+	SCOPE_CYCLE_COUNTER(STAT_TGMWriteShots);
+
+	// Chunks hold at most QueueCapacity records, so readers can bound what they allocate per chunk
+	do
+	{
+		Batch.Reset();
+
+		FTGMShotRecord ShotRecord;
+		while (Batch.Num() < int32(QueueCapacity) && Queue.Dequeue(ShotRecord))
+		{
+			Batch.Add(ShotRecord);
+		}
+
+		if (Batch.Num() == 0)
+		{
+			return;
+		}
+
+		const int32 UncompressedSize = Batch.Num() * Batch.GetTypeSize();
+		int32 CompressedSize = FCompression::CompressMemoryBound(NAME_Zlib, UncompressedSize);
+		CompressedBatch.SetNumUninitialized(CompressedSize, false);
+
+		if (!FCompression::CompressMemory(NAME_Zlib, CompressedBatch.GetData(), CompressedSize, Batch.GetData(), UncompressedSize))
+		{
+			UE_LOG(LogTGMTelemetry, Warning, TEXT("Failed to compress %d shot records, dropping them"), Batch.Num());
+			return;
+		}
+
+		if (!File.IsValid() || File->TotalSize() >= MaxFileSize)
+		{
+			RotateFile();
+
+			if (!File.IsValid())
+			{
+				return;
+			}
+		}
+
+		TGMShotTelemetry::FChunkHeader Header;
+		Header.Magic = TGMShotTelemetry::Magic;
+		Header.Version = TGMShotTelemetry::Version;
+		Header.RecordSize = sizeof(FTGMShotRecord);
+		Header.NumRecords = Batch.Num();
+		Header.CompressedSize = CompressedSize;
+
+		File->Serialize(&Header, sizeof(Header));
+		File->Serialize(CompressedBatch.GetData(), CompressedSize);
+		File->Flush();
+
+		BytesWritten += sizeof(Header) + CompressedSize;
+	}
+	while (Batch.Num() == int32(QueueCapacity));
+}
+
+void FTGMShotTelemetryWriter::RotateFile()
+{
+	File.Reset();
+
+	IFileManager& FileManager = IFileManager::Get();
+	FileManager.MakeDirectory(*Directory, true);
+
+	// Timestamped names sort chronologically, the index keeps them unique within a second
+	const FString FileName = FString::Printf(TEXT("Shots_%s_%03d%s"), *FDateTime::UtcNow().ToString(TEXT("%Y%m%d_%H%M%S")), FileIndex++, TGMShotTelemetry::FileExtension);
+	File.Reset(FileManager.CreateFileWriter(*(Directory / FileName)));
+
+	if (!File.IsValid())
+	{
+		UE_LOG(LogTGMTelemetry, Warning, TEXT("Failed to create telemetry file %s"), *(Directory / FileName));
+		return;
+	}
+
+	// Delete the oldest files beyond MaxFiles, counting the new one
+	TArray<FString> FileNames;
+	FileManager.FindFiles(FileNames, *Directory, TGMShotTelemetry::FileExtension);
+	FileNames.Sort();
+
+	for (int32 i = 0; i < FileNames.Num() - MaxFiles; i++)
+	{
+		FileManager.Delete(*(Directory / FileNames[i]));
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// UTGMShotTelemetrySubsystem
+
+void UTGMShotTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (bEnabled)
+	{
+		Writer = MakeUnique<FTGMShotTelemetryWriter>(TGMShotTelemetry::GetDefaultDirectory(), int64(MaxFileSizeKB) * 1024, MaxFiles, FlushInterval);
+	}
+}
+
+void UTGMShotTelemetrySubsystem::Deinitialize()
+{
+	// Destroying the writer flushes anything still queued
+	Writer.Reset();
+
+	Super::Deinitialize();
+}
+
+void UTGMShotTelemetrySubsystem::RecordShot(const FTGMShotRecord& ShotRecord)
+{
+	if (Writer.IsValid())
+	{
+		Writer->Record(ShotRecord);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Benchmark
+
+static void BenchShotTelemetry(const TArray<FString>& Args)
+{
+	const int32 NumShots = (Args.Num() > 0) ? FCString::Atoi(*Args[0]) : 100000;
+
+	if (NumShots <= 0)
+	{
+		UE_LOG(LogTGMTelemetry, Warning, TEXT("Usage: TGM.BenchShotTelemetry [NumShots]"));
+		return;
+	}
+
+	const FString Directory = TGMShotTelemetry::GetDefaultDirectory() / TEXT("Bench");
+	IFileManager::Get().DeleteDirectory(*Directory, false, true);
+
+	FTGMShotTelemetryWriter Writer(Directory, 4 * 1024 * 1024, 8, 1.0f);
+
+	FTGMShotRecord ShotRecord;
+	FMemory::Memzero(ShotRecord);
+	ShotRecord.TurnRateMultiplier = 0.06f;
+	ShotRecord.BoostSpeedMultiplier = 2.0f;
+	ShotRecord.ProjectileLifeSpan = 7.0f;
+
+	double RecordTime = 0.0;
+	int32 NumDropped = 0;
+
+	// Record in bursts of half the queue, letting the writer drain in between like it would across frames
+	const int32 BurstSize = FTGMShotTelemetryWriter::QueueCapacity / 2;
+	for (int32 Start = 0; Start < NumShots; Start += BurstSize)
+	{
+		const int32 End = FMath::Min(NumShots, Start + BurstSize);
+		const double BurstStart = FPlatformTime::Seconds();
+
+		for (int32 i = Start; i < End; i++)
+		{
+			ShotRecord.FireTime = i;
+			ShotRecord.FlightDuration = (i % 700) * 0.01f;
+			ShotRecord.BoostTime = (i % 3 == 0) ? -1.0f : (i % 200) * 0.01f;
+			ShotRecord.DistanceFlown = (i % 1000) * 10.0f;
+			ShotRecord.NumComponentsHit = i % 16;
+			ShotRecord.ExplodeCause = i % uint8(ETGMExplodeCause::Num);
+
+			NumDropped += Writer.Record(ShotRecord) ? 0 : 1;
+		}
+
+		RecordTime += FPlatformTime::Seconds() - BurstStart;
+
+		Writer.Flush();
+		FPlatformProcess::Sleep(0.005f);
+	}
+
+	UE_LOG(LogTGMTelemetry, Display, TEXT("Shot telemetry: %d records, %.1f ns per record on the calling thread, %d dropped"),
+		NumShots, RecordTime * 1e9 / NumShots, NumDropped);
+}
+
+static FAutoConsoleCommand BenchShotTelemetryCommand(
+	TEXT("TGM.BenchShotTelemetry"),
+	TEXT("Measures the calling thread cost of recording shot telemetry. Usage: TGM.BenchShotTelemetry [NumShots=100000]"),
+	FConsoleCommandWithArgsDelegate::CreateStatic(&BenchShotTelemetry));
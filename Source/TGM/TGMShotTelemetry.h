@@ -0,0 +1,170 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "HAL/Runnable.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "TGMShotTelemetry.generated.h"
+
+/**
+ * Why a projectile exploded
+ */
+enum class ETGMExplodeCause : uint8
+{
+	Hit,
+	Manual,
+	LifeSpan,
+
+	Num
+};
+
+/**
+ * One fired projectile, written as-is to the telemetry files. Changing the layout requires bumping TGMShotTelemetry::Version.
+ */
+struct FTGMShotRecord
+{
+	// UTC time the projectile was fired, in seconds since the Unix epoch
+	double FireTime;
+
+	// Time between firing and exploding, in seconds
+	float FlightDuration;
+
+	// Time between firing and boosting, in seconds, negative if the projectile was never boosted
+	float BoostTime;
+
+	// Length of the flight path, in cm
+	float DistanceFlown;
+
+	// Handling and lifespan tuning the projectile was fired with
+	float TurnRateMultiplier;
+	float BoostSpeedMultiplier;
+	float ProjectileLifeSpan;
+
+	// Number of components caught in the explosion
+	uint16 NumComponentsHit;
+
+	// ETGMExplodeCause
+	uint8 ExplodeCause;
+
+	uint8 Padding[5];
+};
+
+static_assert(sizeof(FTGMShotRecord) == 40, "FTGMShotRecord layout changed, bump TGMShotTelemetry::Version");
+
+namespace TGMShotTelemetry
+{
+	// File format: a sequence of chunks, each a FChunkHeader followed by CompressedSize bytes of zlib compressed records
+	static constexpr uint32 Magic = 0x534D4754; // "TGMS"
+	static constexpr uint16 Version = 1;
+
+	// Extension of telemetry files
+	static const TCHAR* const FileExtension = TEXT(".tgmshots");
+
+	struct FChunkHeader
+	{
+		uint32 Magic;
+		uint16 Version;
+		uint16 RecordSize;
+		uint32 NumRecords;
+		uint32 CompressedSize;
+	};
+
+	// Default directory telemetry files are written to
+	TGM_API FString GetDefaultDirectory();
+}
+
+/**
+ * Writes shot records to compressed, rotating files on a background thread.
+ * The game thread only copies records into a preallocated lock-free single-producer/single-consumer queue.
+ */
+class TGM_API FTGMShotTelemetryWriter : public FRunnable
+{
+public:
+	/**
+	 * @param InDirectory		Directory the telemetry files are written to
+	 * @param InMaxFileSize		Size in bytes after which a new file is started
+	 * @param InMaxFiles		Number of files kept, the oldest are deleted
+	 * @param InFlushInterval	Time in seconds between background flushes
+	 */
+	FTGMShotTelemetryWriter(const FString& InDirectory, int64 InMaxFileSize, int32 InMaxFiles, float InFlushInterval);
+	virtual ~FTGMShotTelemetryWriter();
+
+	/** Queue a record for writing. Never blocks or allocates; returns false if the queue is full and the record was dropped. */
+	bool Record(const FTGMShotRecord& ShotRecord);
+
+	/** Wake the background thread to write queued records now */
+	void Flush();
+
+	/** Total compressed bytes written so far */
+	int64 GetBytesWritten() const { return BytesWritten; }
+
+	// FRunnable interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	// End of FRunnable interface
+
+	// Number of records the queue can hold between two flushes
+	static constexpr uint32 QueueCapacity = 4096;
+
+private:
+	// Background thread: drain the queue and write it as one chunk
+	void WritePending();
+
+	// Background thread: close the current file, start a new one and delete the oldest ones
+	void RotateFile();
+
+	TCircularQueue<FTGMShotRecord> Queue;
+
+	FString Directory;
+	int64 MaxFileSize;
+	int32 MaxFiles;
+	float FlushInterval;
+
+	FRunnableThread* Thread;
+	FEvent* WakeEvent;
+	TAtomic<bool> bStopping;
+	TAtomic<int64> BytesWritten;
+
+	// Background thread state
+	TUniquePtr<FArchive> File;
+	int32 FileIndex;
+	TArray<FTGMShotRecord> Batch;
+	TArray<uint8> CompressedBatch;
+};
+
+/**
+ * Owns the shot telemetry writer for the lifetime of the game instance
+ */
+UCLASS(config=Game)
+class TGM_API UTGMShotTelemetrySubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// USubsystem interface
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	// End of USubsystem interface
+
+	/** Record a finished shot. Cheap enough to call from the game thread on every explosion. */
+	void RecordShot(const FTGMShotRecord& ShotRecord);
+
+	/** Whether shot telemetry is recorded */
+	UPROPERTY(Config)
+	bool bEnabled = true;
+
+	/** Size in KB after which a new telemetry file is started */
+	UPROPERTY(Config)
+	int32 MaxFileSizeKB = 4096;
+
+	/** Number of telemetry files kept */
+	UPROPERTY(Config)
+	int32 MaxFiles = 8;
+
+	/** Time in seconds between background flushes */
+	UPROPERTY(Config)
+	float FlushInterval = 1.0f;
+
+private:
+	TUniquePtr<FTGMShotTelemetryWriter> Writer;
+};
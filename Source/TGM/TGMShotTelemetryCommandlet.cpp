@@ -0,0 +1,140 @@
+#include "TGMShotTelemetryCommandlet.h"
+#include "TGMShotTelemetry.h"
+#include "HAL/FileManager.h"
+#include "Misc/Compression.h"
+#include "Misc/FileHelper.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogTGMTelemetryReader, Log, All);
+
+namespace
+{
+	// Aggregated shots fired with the same tuning
+	struct FShotAggregate
+	{
+		int32 NumShots = 0;
+		int32 NumBoosted = 0;
+		int32 NumByCause[uint8(ETGMExplodeCause::Num)] = {};
+		double TotalFlightDuration = 0.0;
+		double TotalBoostTime = 0.0;
+		double TotalDistance = 0.0;
+		int64 TotalComponentsHit = 0;
+
+		void Add(const FTGMShotRecord& ShotRecord)
+		{
+			NumShots++;
+			TotalFlightDuration += ShotRecord.FlightDuration;
+			TotalDistance += ShotRecord.DistanceFlown;
+			TotalComponentsHit += ShotRecord.NumComponentsHit;
+
+			if (ShotRecord.BoostTime >= 0.0f)
+			{
+				NumBoosted++;
+				TotalBoostTime += ShotRecord.BoostTime;
+			}
+
+			if (ShotRecord.ExplodeCause < uint8(ETGMExplodeCause::Num))
+			{
+				NumByCause[ShotRecord.ExplodeCause]++;
+			}
+		}
+	};
+
+	// Reads every chunk of a telemetry file, returns false if the file is malformed
+	bool ReadShotFile(const FString& Path, TArray<FTGMShotRecord>& OutRecords)
+	{
+		TArray<uint8> Data;
+		if (!FFileHelper::LoadFileToArray(Data, *Path))
+		{
+			return false;
+		}
+
+		int64 Offset = 0;
+		while (Offset + int64(sizeof(TGMShotTelemetry::FChunkHeader)) <= Data.Num())
+		{
+			TGMShotTelemetry::FChunkHeader Header;
+			FMemory::Memcpy(&Header, Data.GetData() + Offset, sizeof(Header));
+			Offset += sizeof(Header);
+
+			// The writer never puts more than QueueCapacity records in a chunk, a larger count means a corrupt header
+			if (Header.Magic != TGMShotTelemetry::Magic || Header.Version != TGMShotTelemetry::Version || Header.RecordSize != sizeof(FTGMShotRecord)
+				|| Header.NumRecords > FTGMShotTelemetryWriter::QueueCapacity || Offset + Header.CompressedSize > Data.Num())
+			{
+				return false;
+			}
+
+			const int32 NumRecords = int32(Header.NumRecords);
+			const int32 FirstRecord = OutRecords.AddUninitialized(NumRecords);
+			if (!FCompression::UncompressMemory(NAME_Zlib, OutRecords.GetData() + FirstRecord, NumRecords * int32(sizeof(FTGMShotRecord)), Data.GetData() + Offset, Header.CompressedSize))
+			{
+				OutRecords.SetNum(FirstRecord);
+				return false;
+			}
+
+			Offset += Header.CompressedSize;
+		}
+
+		return true;
+	}
+}
+
+UTGMShotTelemetryCommandlet::UTGMShotTelemetryCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+int32 UTGMShotTelemetryCommandlet::Main(const FString& Params)
+{
+	FString Directory;
+	if (!FParse::Value(*Params, TEXT("Dir="), Directory))
+	{
+		Directory = TGMShotTelemetry::GetDefaultDirectory();
+	}
+
+	TArray<FString> FileNames;
+	IFileManager::Get().FindFiles(FileNames, *Directory, TGMShotTelemetry::FileExtension);
+	FileNames.Sort();
+
+	TArray<FTGMShotRecord> Records;
+	for (const FString& FileName : FileNames)
+	{
+		if (!ReadShotFile(Directory / FileName, Records))
+		{
+			UE_LOG(LogTGMTelemetryReader, Warning, TEXT("%s is truncated or malformed, using the records read so far"), *FileName);
+		}
+	}
+
+	UE_LOG(LogTGMTelemetryReader, Display, TEXT("Read %d shots from %d files in %s"), Records.Num(), FileNames.Num(), *Directory);
+
+	// Group shots by the tuning they were fired with
+	TMap<FString, FShotAggregate> Aggregates;
+	for (const FTGMShotRecord& ShotRecord : Records)
+	{
+		const FString Key = FString::Printf(TEXT("TurnRate=%.3f BoostSpeed=%.2f LifeSpan=%.1f"), ShotRecord.TurnRateMultiplier, ShotRecord.BoostSpeedMultiplier, ShotRecord.ProjectileLifeSpan);
+		Aggregates.FindOrAdd(Key).Add(ShotRecord);
+	}
+
+	Aggregates.KeySort(TLess<FString>());
+
+	for (const TPair<FString, FShotAggregate>& Pair : Aggregates)
+	{
+		const FShotAggregate& Aggregate = Pair.Value;
+		const double NumShots = Aggregate.NumShots;
+
+		UE_LOG(LogTGMTelemetryReader, Display, TEXT("%s: %d shots, flight %.2fs, distance %.0fcm, %.2f components hit, boosted %.0f%% (after %.2fs), hit %.0f%% / manual %.0f%% / lifespan %.0f%%"),
+			*Pair.Key,
+			Aggregate.NumShots,
+			Aggregate.TotalFlightDuration / NumShots,
+			Aggregate.TotalDistance / NumShots,
+			Aggregate.TotalComponentsHit / NumShots,
+			100.0 * Aggregate.NumBoosted / NumShots,
+			(Aggregate.NumBoosted > 0) ? Aggregate.TotalBoostTime / Aggregate.NumBoosted : 0.0,
+			100.0 * Aggregate.NumByCause[uint8(ETGMExplodeCause::Hit)] / NumShots,
+			100.0 * Aggregate.NumByCause[uint8(ETGMExplodeCause::Manual)] / NumShots,
+			100.0 * Aggregate.NumByCause[uint8(ETGMExplodeCause::LifeSpan)] / NumShots);
+	}
+
+	return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "TGMShotTelemetryCommandlet.generated.h"
+
+/**
+ * Offline reader for shot telemetry files. Prints per-tuning aggregates of all shots found.
+ * Usage: UE4Editor-Cmd TGM.uproject -run=TGMShotTelemetry [-Dir=<telemetry directory>]
+ */
+UCLASS()
+class UTGMShotTelemetryCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UTGMShotTelemetryCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,53 @@
+#include "TGMSteeringInput.h"
+#include "TGM.h"
+#include "Input/Events.h"
+#include "Widgets/SViewport.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("Steering Samples Received"), STAT_TGMSteeringSamplesReceived, STATGROUP_TGM);
+DECLARE_DWORD_ACCUMULATOR_STAT(TEXT("Steering Samples Dropped"), STAT_TGMSteeringSamplesDropped, STATGROUP_TGM);
+
+FTGMSteeringInputProcessor::FTGMSteeringInputProcessor(float InYawScale, float InPitchScale, TSharedPtr<SViewport> InViewport)
+	: Samples(QueueCapacity)
+	, YawScale(InYawScale)
+	, PitchScale(InPitchScale)
+	, Viewport(InViewport)
+{
+}
+
+void FTGMSteeringInputProcessor::Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor)
+{
+	// Samples are stamped as they arrive, nothing to do once per Slate tick
+}
+
+bool FTGMSteeringInputProcessor::HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent)
+{
+	// Mouse moves over other widgets, e.g. the editor around a PIE viewport, are not steering input
+	TSharedPtr<SViewport> PinnedViewport = Viewport.Pin();
+	if (!PinnedViewport.IsValid() || !PinnedViewport->HasMouseCapture())
+	{
+		return false;
+	}
+
+	const FVector2D Delta = MouseEvent.GetCursorDelta();
+
+	if (!Delta.IsZero())
+	{
+		FTGMSteeringSample Sample;
+		Sample.Timestamp = FPlatformTime::Seconds();
+		Sample.Yaw = Delta.X * YawScale;
+
+		// Slate's cursor delta grows downwards, the MouseY axis grows upwards
+		Sample.Pitch = -Delta.Y * PitchScale;
+
+		INC_DWORD_STAT(STAT_TGMSteeringSamplesReceived);
+
+		// If the consumer fell behind, drop the newest sample rather than blocking the producer
+		if (!Samples.Enqueue(Sample))
+		{
+			INC_DWORD_STAT(STAT_TGMSteeringSamplesDropped);
+		}
+	}
+
+	// Never consume the event, regular input routing should still see it
+	return false;
+}
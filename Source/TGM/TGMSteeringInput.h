@@ -0,0 +1,56 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/CircularQueue.h"
+#include "Framework/Application/IInputProcessor.h"
+
+/**
+ * Single raw steering sample, in the same units the "Turn"/"LookUp" axis bindings would report
+ */
+struct FTGMSteeringSample
+{
+	// Platform time (FPlatformTime::Seconds) at which the input event was received
+	double Timestamp;
+
+	// Yaw axis value of this sample
+	float Yaw;
+
+	// Pitch axis value of this sample
+	float Pitch;
+};
+
+/**
+ * Slate input pre-processor that captures mouse deltas as individual events instead of the
+ * per-frame axis sum. Samples are pushed into a lock-free single-producer/single-consumer
+ * queue and drained by the projectile guidance step.
+ */
+class FTGMSteeringInputProcessor : public IInputProcessor
+{
+public:
+	/**
+	 * @param InYawScale	Scale applied to MouseX deltas (sensitivity, inversion and "Turn" mapping scale)
+	 * @param InPitchScale	Scale applied to MouseY deltas (sensitivity, inversion and "LookUp" mapping scale)
+	 * @param InViewport	Game viewport that must have mouse capture for samples to be recorded
+	 */
+	FTGMSteeringInputProcessor(float InYawScale, float InPitchScale, TSharedPtr<class SViewport> InViewport);
+
+	// IInputProcessor interface
+	virtual void Tick(const float DeltaTime, FSlateApplication& SlateApp, TSharedRef<ICursor> Cursor) override;
+	virtual bool HandleMouseMoveEvent(FSlateApplication& SlateApp, const FPointerEvent& MouseEvent) override;
+	// End of IInputProcessor interface
+
+	/** Pops the oldest pending sample. Must only be called from the consuming side. */
+	bool Dequeue(FTGMSteeringSample& OutSample) { return Samples.Dequeue(OutSample); }
+
+private:
+	// Number of samples the queue can hold before new ones are dropped
+	static constexpr uint32 QueueCapacity = 256;
+
+	TCircularQueue<FTGMSteeringSample> Samples;
+
+	float YawScale;
+
+	float PitchScale;
+
+	TWeakPtr<class SViewport> Viewport;
+};